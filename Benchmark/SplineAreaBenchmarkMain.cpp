@@ -0,0 +1,47 @@
+// Copyright 2021 Robin Smekens
+
+#include "SplineAreaGeometryCorpus.h"
+
+#include <cstdio>
+#include <cstring>
+
+/// <summary>
+/// Runs the polygon corpus outside of the engine, the benchmark of the SplineArea.Benchmark console command by default or
+/// one of the suites of the SplineArea.Geometry automation tests. Exits with 1 when any check fails, so a build machine can
+/// run it after every change
+/// </summary>
+int main(const int argumentCount, char** arguments)
+{
+    using namespace SplineAreaGeometryCorpus;
+
+    CorpusLog log;
+    log.Info = [](const std::string& message)
+    {
+        std::printf("%s\n", message.c_str());
+    };
+    log.Error = [](const std::string& message)
+    {
+        std::fprintf(stderr, "Error: %s\n", message.c_str());
+    };
+
+    const char* suite = argumentCount > 1 ? arguments[1] : "benchmark";
+    int failureCount = 0;
+    if (std::strcmp(suite, "benchmark") == 0)
+        failureCount = RunBenchmark(log);
+    else if (std::strcmp(suite, "stress") == 0)
+        failureCount = RunStressTest(log, 1, 500);
+    else if (std::strcmp(suite, "scaling") == 0)
+        failureCount = RunScalingTest(log);
+    else if (std::strcmp(suite, "holes") == 0)
+        failureCount = RunHoleTest(log, 1, 200);
+    else if (std::strcmp(suite, "union") == 0)
+        failureCount = RunUnionTest(log, 1, 200);
+    else if (std::strcmp(suite, "edits") == 0)
+        failureCount = RunIncrementalEditTest(log, 1, 500);
+    else
+    {
+        std::fprintf(stderr, "Usage: %s [benchmark|stress|scaling|holes|union|edits]\n", arguments[0]);
+        return 1;
+    }
+    return failureCount > 0 ? 1 : 0;
+}
@@ -1,14 +1,164 @@
 // Copyright 2021 Robin Smekens
 
 #include "ASplineArea.h"
+#include "SplineArea.h"
+#include "SplineAreaGeometry.h"
 #include "ProceduralMeshComponent.h"
 #include "Components/SplineComponent.h"
+#include "Async/Async.h"
 #include "Engine/StaticMesh.h"
 
 #include "Materials/MaterialInterface.h"
 #include "Components/InstancedStaticMeshComponent.h"
-#include "Kismet/KismetMathLibrary.h"
 #include "UObject/ConstructorHelpers.h"
+#include "Misc/Crc.h"
+#include "USplineAreaSubsystem.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/Pawn.h"
+#include "Kismet/GameplayStatics.h"
+#include "TimerManager.h"
+
+/// <summary>
+/// Converts an engine vector to the vector type used by the triangulation
+/// </summary>
+inline SplineAreaGeometry::Vector3 ToGeometryVector(const FVector& vector)
+{
+    return {vector.X, vector.Y, vector.Z};
+}
+
+/// <summary>
+/// Adds the counters of one triangulation to the per frame stats and the CSV profile
+/// </summary>
+inline void RecordTriangulationStats(const SplineAreaGeometry::TriangulationStats& stats)
+{
+    INC_DWORD_STAT_BY(STAT_SplineArea_Vertices, stats.VertexCount);
+    INC_DWORD_STAT_BY(STAT_SplineArea_ReflexVertices, stats.ReflexCount);
+    INC_DWORD_STAT_BY(STAT_SplineArea_EarIterations, stats.EarIterations);
+    INC_DWORD_STAT_BY(STAT_SplineArea_Triangles, stats.TrianglesEmitted);
+    INC_DWORD_STAT_BY(STAT_SplineArea_Allocations, stats.Allocations);
+    INC_DWORD_STAT_BY(STAT_SplineArea_ScratchBytes, stats.ScratchBytes);
+
+    CSV_CUSTOM_STAT(SplineArea, Vertices, stats.VertexCount, ECsvCustomStatOp::Accumulate);
+    CSV_CUSTOM_STAT(SplineArea, ReflexVertices, stats.ReflexCount, ECsvCustomStatOp::Accumulate);
+    CSV_CUSTOM_STAT(SplineArea, EarIterations, stats.EarIterations, ECsvCustomStatOp::Accumulate);
+    CSV_CUSTOM_STAT(SplineArea, Triangles, stats.TrianglesEmitted, ECsvCustomStatOp::Accumulate);
+    CSV_CUSTOM_STAT(SplineArea, Allocations, stats.Allocations, ECsvCustomStatOp::Accumulate);
+}
+
+/// <summary>
+/// Triangulates the points, the triangles index straight into them so the vertex buffer is the spline itself and nothing needs welding.
+/// Does not touch any UObject so it is safe to call from worker threads, every thread keeps its own triangulator and conversion
+/// buffers so triangulating an area does not allocate once they fit the largest area seen on that thread
+/// </summary>
+/// <param name="splinePoints"> Positional data of the spline followed by its holes </param>
+/// <param name="holeStarts"> Index of the first point of every hole, the holes get bridged into the outline in the same pass </param>
+/// <param name="outIndices"> Array the triangle indices get appended to </param>
+/// <returns> False when the outline crosses itself, the triangles then overlap where it does </returns>
+inline bool TriangulatePoints(const TArray<FVector>& splinePoints, const TArray<int32>& holeStarts, TArray<int32>& outIndices)
+{
+    if (splinePoints.Num() < 3)
+        return true;
+
+    SPLINEAREA_SCOPE(Triangulate);
+
+    thread_local SplineAreaGeometry::Triangulator triangulator;
+    thread_local std::vector<SplineAreaGeometry::Vector3> points;
+    thread_local std::vector<int> holes;
+    thread_local std::vector<int> indices;
+
+    const size_t pointCapacity = points.capacity();
+    points.clear();
+    points.reserve(splinePoints.Num());
+    for (const FVector& splinePoint : splinePoints)
+    {
+        points.push_back(ToGeometryVector(splinePoint));
+    }
+
+    indices.clear();
+    SplineAreaGeometry::TriangulationStats stats;
+    if (holeStarts.Num() > 0)
+    {
+        SPLINEAREA_SCOPE(TrianglesFromPoints);
+        holes.assign(holeStarts.GetData(), holeStarts.GetData() + holeStarts.Num());
+        triangulator.TriangulateWithHoles(points, holes, indices, &stats);
+    }
+    else
+    {
+        {
+            SPLINEAREA_SCOPE(PolygonComponents);
+            triangulator.ClassifyPoints(points);
+        }
+        SPLINEAREA_SCOPE(TrianglesFromPoints);
+        triangulator.ClipEars(points, indices, &stats);
+    }
+    if (points.capacity() != pointCapacity)
+        stats.Allocations++;
+    RecordTriangulationStats(stats);
+    outIndices.Append(indices.data(), indices.size());
+    return !stats.bSelfIntersecting;
+}
+
+/// <summary>
+/// Appends the points of one spline segment, pieces get split in half until their middle lies within maxError of the straight
+/// line between their ends. The first point of the segment is added, the last one is not
+/// </summary>
+/// <param name="spline"> Spline to flatten </param>
+/// <param name="segmentIndex"> Index of the spline point the segment starts at </param>
+/// <param name="maxError"> Largest allowed distance between the curve and the points </param>
+/// <param name="outPoints"> Array the points get appended to </param>
+inline void FlattenSplineSegment(const USplineComponent* spline, const int segmentIndex, const float maxError,
+                                 TArray<FVector>& outPoints)
+{
+    struct FCurvePiece
+    {
+        float StartKey;
+        float EndKey;
+        FVector Start;
+        FVector End;
+        int Depth;
+    };
+    //2^8 pieces per segment at most, so a tiny tolerance can not blow up the point count
+    const int maxDepth = 8;
+
+    const float startKey = static_cast<float>(segmentIndex);
+    const float endKey = startKey + 1.f;
+    const FVector start = spline->GetLocationAtSplineInputKey(startKey, ESplineCoordinateSpace::Local);
+    const FVector end = spline->GetLocationAtSplineInputKey(endKey, ESplineCoordinateSpace::Local);
+    outPoints.Add(start);
+
+    //Depth first with the first half on top of the stack, so the points come out in order
+    TArray<FCurvePiece, TInlineAllocator<16>> pieces;
+    pieces.Push({startKey, endKey, start, end, 0});
+    while (pieces.Num() > 0)
+    {
+        const FCurvePiece piece = pieces.Pop(false);
+        const float midKey = 0.5f * (piece.StartKey + piece.EndKey);
+        const FVector mid = spline->GetLocationAtSplineInputKey(midKey, ESplineCoordinateSpace::Local);
+
+        float error = FMath::PointDistToSegment(mid, piece.Start, piece.End);
+        if (piece.Depth == 0)
+        {
+            //An S shaped segment can have its middle right on the chord, the quarters catch that
+            const float quarterKey = 0.25f * (piece.EndKey - piece.StartKey);
+            error = FMath::Max(error, FMath::PointDistToSegment(
+                                   spline->GetLocationAtSplineInputKey(piece.StartKey + quarterKey, ESplineCoordinateSpace::Local),
+                                   piece.Start, piece.End));
+            error = FMath::Max(error, FMath::PointDistToSegment(
+                                   spline->GetLocationAtSplineInputKey(piece.EndKey - quarterKey, ESplineCoordinateSpace::Local),
+                                   piece.Start, piece.End));
+        }
+
+        if (error > maxError && piece.Depth < maxDepth)
+        {
+            pieces.Push({midKey, piece.EndKey, mid, piece.End, piece.Depth + 1});
+            pieces.Push({piece.StartKey, midKey, piece.Start, mid, piece.Depth + 1});
+        }
+        else if (piece.EndKey != endKey)
+        {
+            outPoints.Add(piece.End);
+        }
+    }
+}
 
 // Sets default values
 ASplineArea::ASplineArea()
@@ -64,6 +214,53 @@ ASplineArea::ASplineArea()
 void ASplineArea::BeginPlay()
 {
     Super::BeginPlay();
+
+    if (bUseSharedBatch || bMergeOverlappingAreas)
+    {
+        if (USplineAreaSubsystem* subsystem = GetWorld()->GetSubsystem<USplineAreaSubsystem>())
+        {
+            //The own components keep the collision but no longer draw anything
+            bRegisteredInBatch = true;
+            pAreaMesh->SetVisibility(false);
+            ApplyAreaOutline(CachedOutlineTransforms);
+            subsystem->RegisterArea(this);
+        }
+    }
+
+    //Nothing gets drawn or collides until the first relevance check finds a source close enough
+    if (bLazyActivation)
+        ReleaseAreaResources();
+
+    if (AreaLODs.Num() > 0 && !bRegisteredInBatch)
+    {
+        CreateAreaLODs();
+        const float interval = FMath::Max(LODUpdateInterval, 0.05f);
+        GetWorldTimerManager().SetTimer(LODTimerHandle, this, &ASplineArea::UpdateAreaLOD, interval, true,
+                                        FMath::FRandRange(0.f, interval));
+    }
+
+    if (bLazyActivation)
+    {
+        const float interval = FMath::Max(RelevanceUpdateInterval, 0.05f);
+        GetWorldTimerManager().SetTimer(RelevanceTimerHandle, this, &ASplineArea::UpdateAreaRelevance, interval, true,
+                                        FMath::FRandRange(0.f, interval));
+        UpdateAreaRelevance();
+    }
+}
+
+void ASplineArea::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    GetWorldTimerManager().ClearTimer(LODTimerHandle);
+    GetWorldTimerManager().ClearTimer(RelevanceTimerHandle);
+
+    if (bRegisteredInBatch)
+    {
+        if (USplineAreaSubsystem* subsystem = GetWorld()->GetSubsystem<USplineAreaSubsystem>())
+            subsystem->UnregisterArea(this);
+        bRegisteredInBatch = false;
+    }
+
+    Super::EndPlay(EndPlayReason);
 }
 
 // Called every frame
@@ -74,23 +271,228 @@ void ASplineArea::Tick(float DeltaTime)
 
 void ASplineArea::OnConstruction(const FTransform& Transform)
 {
-    CreateTeleportationArea();
+    //Holes close like the outline does
+    TArray<USplineComponent*> holeSplines;
+    GetHoleSplines(holeSplines);
+    for (USplineComponent* holeSpline : holeSplines)
+    {
+        if (!holeSpline->IsClosedLoop())
+            holeSpline->SetClosedLoop(true);
+    }
+
+    if (!CreateTeleportationAreaFromCache())
+        UpdateTeleportationArea();
+
+    //Curved areas keep the point types the designer picked
+    if (bCurvedArea)
+        return;
 
     for (int i = 0; i < pSpline->GetNumberOfSplinePoints(); i++)
     {
         pSpline->SetSplinePointType(i, ESplinePointType::Linear, false);
     }
+    for (USplineComponent* holeSpline : holeSplines)
+    {
+        for (int i = 0; i < holeSpline->GetNumberOfSplinePoints(); i++)
+        {
+            holeSpline->SetSplinePointType(i, ESplinePointType::Linear, false);
+        }
+    }
 }
 
 void ASplineArea::CreateTeleportationArea()
 {
-    VisualizationTriangles.Reset(0);
-    TArray<MeshTriangle> meshTriangles;
+    //Anything still running on a worker is older than this
+    GenerationSerial->Increment();
+    bAsyncGenerationPending = false;
+
+    AreaVertices.Reset();
+    AreaHoleStarts.Reset();
+    AreaIndices.Reset();
+    bAreaQueryDirty = true;
+    bAreaBoundsDirty = true;
+    bAreaAdjacencyDirty = true;
+    RecordAreaRebuild();
 
     TriangulateSpline();
 
     CreateAreaMesh();
     CreateAreaOutline();
+    CachedAreaHash = ComputeAreaHash(AreaVertices, AreaHoleStarts);
+    if (LODData.Num() > 0)
+        CreateAreaLODs();
+}
+
+void ASplineArea::UpdateTeleportationArea()
+{
+    GenerationSerial->Increment();
+    bAsyncGenerationPending = false;
+
+    TArray<FVector> splinePoints;
+    TArray<int32> holeStarts;
+    GetAreaPoints(splinePoints, holeStarts);
+
+    //The local updates only know a single outline, areas with holes always triangulate again
+    bool bIndicesChanged = true;
+    if (holeStarts.Num() > 0 || AreaHoleStarts.Num() > 0 || !RetriangulateChangedPoints(splinePoints, bIndicesChanged))
+    {
+        INC_DWORD_STAT(STAT_SplineArea_IncrementalFallbacks);
+        CSV_CUSTOM_STAT(SplineArea, IncrementalFallbacks, 1, ECsvCustomStatOp::Accumulate);
+        UE_LOG(LogSplineArea, Verbose, TEXT("%s: the edit could not be applied locally, triangulating the whole area"), *GetName());
+        CreateTeleportationArea();
+        return;
+    }
+    RecordAreaRebuild();
+
+    if (bIndicesChanged)
+        CreateAreaMesh();
+    else
+        UpdateAreaMeshVertices();
+    CreateAreaOutline();
+    CachedAreaHash = ComputeAreaHash(AreaVertices, AreaHoleStarts);
+    if (LODData.Num() > 0)
+        CreateAreaLODs();
+}
+
+uint32 ASplineArea::ComputeAreaHash(const TArray<FVector>& splinePoints, const TArray<int32>& holeStarts) const
+{
+    //Bump the version when the generated data changes so caches saved by older versions get rebuilt
+    const uint32 cacheVersion = 4;
+    uint32 hash = FCrc::MemCrc32(splinePoints.GetData(), splinePoints.Num() * sizeof(FVector), cacheVersion);
+    hash = FCrc::MemCrc32(holeStarts.GetData(), holeStarts.Num() * sizeof(int32), hash);
+    hash = FCrc::MemCrc32(&OutlineWidth, sizeof(OutlineWidth), hash);
+    hash = FCrc::MemCrc32(&AreaUVTileSize, sizeof(AreaUVTileSize), hash);
+    hash = FCrc::MemCrc32(&CollisionMode, sizeof(CollisionMode), hash);
+    hash = FCrc::MemCrc32(&CollisionThickness, sizeof(CollisionThickness), hash);
+    const uint8 outlineEnabled = bEnableOutline ? 1 : 0;
+    return FCrc::MemCrc32(&outlineEnabled, sizeof(outlineEnabled), hash);
+}
+
+bool ASplineArea::CreateTeleportationAreaFromCache()
+{
+    TArray<FVector> splinePoints;
+    TArray<int32> holeStarts;
+    GetAreaPoints(splinePoints, holeStarts);
+    if (AreaIndices.Num() == 0 || ComputeAreaHash(splinePoints, holeStarts) != CachedAreaHash)
+        return false;
+
+    //Construction also runs when the actor only moved, the components still hold the area then
+    const FProcMeshSection* meshSection = pAreaMesh->GetProcMeshSection(0);
+    const bool bMeshUpToDate = AreaVertices == splinePoints && AreaHoleStarts == holeStarts && meshSection != nullptr &&
+        meshSection->ProcIndexBuffer.Num() == AreaIndices.Num();
+    const bool bOutlineUpToDate = pAreaOutline->GetInstanceCount() == (bEnableOutline ? CachedOutlineTransforms.Num() : 0);
+
+    AreaVertices = MoveTemp(splinePoints);
+    AreaHoleStarts = MoveTemp(holeStarts);
+    if (!bMeshUpToDate)
+    {
+        bAreaQueryDirty = true;
+        bAreaBoundsDirty = true;
+        bAreaAdjacencyDirty = true;
+        CreateAreaMesh();
+    }
+    if (!bOutlineUpToDate)
+        ApplyAreaOutline(CachedOutlineTransforms);
+    return true;
+}
+
+void ASplineArea::CreateTeleportationAreaAsync()
+{
+    GenerationSerial->Increment();
+    if (bAsyncGenerationInFlight)
+    {
+        //The running request is stale now, once it reports back one new request runs with the spline at that time
+        bAsyncGenerationPending = true;
+        return;
+    }
+
+    StartAsyncGeneration();
+}
+
+void ASplineArea::StartAsyncGeneration()
+{
+    bAsyncGenerationInFlight = true;
+    bAsyncGenerationPending = false;
+
+    TWeakObjectPtr<ASplineArea> weakThis(this);
+    TSharedRef<FThreadSafeCounter, ESPMode::ThreadSafe> generationSerial = GenerationSerial;
+    const int32 serial = generationSerial->GetValue();
+    TSharedPtr<FSplineAreaBuildData, ESPMode::ThreadSafe> buildData = MakeShared<FSplineAreaBuildData, ESPMode::ThreadSafe>();
+    SnapshotBuildData(*buildData);
+
+    Async(EAsyncExecution::ThreadPool, [weakThis, generationSerial, serial, buildData]() mutable
+          {
+              if (generationSerial->GetValue() == serial)
+                  BuildAreaData(*buildData);
+              else
+                  buildData.Reset();
+
+              AsyncTask(ENamedThreads::GameThread, [weakThis, serial, buildData]()
+              {
+                  if (ASplineArea* area = weakThis.Get())
+                      area->FinishAsyncGeneration(serial, buildData);
+              });
+          });
+}
+
+void ASplineArea::FinishAsyncGeneration(const int32 serial, TSharedPtr<FSplineAreaBuildData, ESPMode::ThreadSafe> buildData)
+{
+    bAsyncGenerationInFlight = false;
+
+    if (serial != GenerationSerial->GetValue() || !buildData.IsValid())
+    {
+        if (bAsyncGenerationPending)
+            StartAsyncGeneration();
+        return;
+    }
+
+    ApplyBuildData(MoveTemp(*buildData));
+}
+
+void ASplineArea::SnapshotBuildData(FSplineAreaBuildData& outBuildData) const
+{
+    GetAreaPoints(outBuildData.Vertices, outBuildData.HoleStarts);
+    outBuildData.Indices.Reset();
+    outBuildData.OutlineTransforms.Reset();
+    outBuildData.OutlineWidth = OutlineWidth;
+    outBuildData.bBuildOutline = bEnableOutline;
+    outBuildData.AreaHash = ComputeAreaHash(outBuildData.Vertices, outBuildData.HoleStarts);
+}
+
+void ASplineArea::BuildAreaData(FSplineAreaBuildData& buildData)
+{
+    buildData.bSelfIntersecting = !TriangulatePoints(buildData.Vertices, buildData.HoleStarts, buildData.Indices);
+    if (buildData.bBuildOutline)
+    {
+        BuildOutlineTransforms(buildData.Vertices, buildData.HoleStarts, buildData.OutlineWidth,
+                               buildData.OutlineTransforms);
+    }
+}
+
+void ASplineArea::ApplyBuildData(FSplineAreaBuildData&& buildData)
+{
+    //Whatever still runs on a worker is older than this result
+    GenerationSerial->Increment();
+    bAsyncGenerationPending = false;
+
+    AreaVertices = MoveTemp(buildData.Vertices);
+    AreaHoleStarts = MoveTemp(buildData.HoleStarts);
+    AreaIndices = MoveTemp(buildData.Indices);
+    CachedOutlineTransforms = MoveTemp(buildData.OutlineTransforms);
+    CachedAreaHash = buildData.AreaHash;
+    bAreaQueryDirty = true;
+    bAreaBoundsDirty = true;
+    bAreaAdjacencyDirty = true;
+    bAreaSelfIntersecting = buildData.bSelfIntersecting;
+    if (buildData.bSelfIntersecting)
+        UE_LOG(LogSplineArea, Warning, TEXT("%s: the spline crosses itself, the area overlaps where it does"), *GetName());
+    RecordAreaRebuild();
+    CreateAreaMesh();
+    ApplyAreaOutline(CachedOutlineTransforms);
+    if (LODData.Num() > 0)
+        CreateAreaLODs();
+
+    OnAreaGenerated.Broadcast(this);
 }
 
 void ASplineArea::ClearSpline() const
@@ -104,316 +506,701 @@ void ASplineArea::ClearSpline() const
     splinePoints.Add(FSplinePoint(3, FVector(-StandardSize, StandardSize, 0.f)));
 
     pSpline->AddPoints(splinePoints, false);
+    const ESplinePointType::Type pointType = bCurvedArea ? ESplinePointType::Curve : ESplinePointType::Linear;
     for (int i = 0; i < pSpline->GetNumberOfSplinePoints(); i++)
     {
-        pSpline->SetSplinePointType(i, ESplinePointType::Linear, false);
+        pSpline->SetSplinePointType(i, pointType, false);
     }
 
     pSpline->SetClosedLoop(true);
 }
 
-/// <summary>
-/// If the index is larger then length it will loop around
-/// </summary>
-/// <param name="index"> index to transform </param>
-/// <param name="length"> maximum value -> length of the array </param>
-inline int CircularIndex(const int index, const int length)
+void ASplineArea::TriangulateSpline()
 {
-    int temp = index % length;
-    int temp1 = temp + length;
-    if (temp < 0)
-        return temp1;
-
-    return temp;
+    GetAreaPoints(AreaVertices, AreaHoleStarts);
+    bAreaSelfIntersecting = !TriangulatePoints(AreaVertices, AreaHoleStarts, AreaIndices);
+    if (bAreaSelfIntersecting)
+        UE_LOG(LogSplineArea, Warning, TEXT("%s: the spline crosses itself, the area overlaps where it does"), *GetName());
 }
 
-/// <summary>
-/// Checks if this is a valid point
-/// </summary>
-/// <param name="t1"> first point </param>
-/// <param name="t2"> second point </param>
-/// <param name="t3"> third point </param>
-inline bool PointIsConvex(FVector prevPoint, FVector curPoint, FVector nextPoint)
+void ASplineArea::GetAreaPoints(TArray<FVector>& outPoints, TArray<int32>& outHoleStarts) const
 {
-    FVector temp1 = prevPoint - curPoint;
-    FVector temp2 = nextPoint - curPoint;
-    temp1.Normalize();
-    temp2.Normalize();
-    FVector temp3 = FVector::CrossProduct(temp1, temp2);
+    outPoints = GetSplinePoints();
+    outHoleStarts.Reset();
 
-    return temp3.Z < 0;
+    TArray<USplineComponent*> holeSplines;
+    GetHoleSplines(holeSplines);
+    const float maxError = FMath::Max(CurveTolerance, 0.1f);
+    TArray<FVector> holePoints;
+    for (const USplineComponent* holeSpline : holeSplines)
+    {
+        const int pointCount = holeSpline->GetNumberOfSplinePoints();
+        if (pointCount < 3)
+            continue;
+
+        holePoints.Reset();
+        for (int i = 0; i < pointCount; i++)
+        {
+            if (bCurvedArea)
+                FlattenSplineSegment(holeSpline, i, maxError, holePoints);
+            else
+                holePoints.Add(holeSpline->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::Local));
+        }
+
+        //The area vertices are local to the outline spline
+        const FTransform toAreaSpace = holeSpline->GetComponentTransform().GetRelativeTransform(pSpline->GetComponentTransform());
+        outHoleStarts.Add(outPoints.Num());
+        for (const FVector& holePoint : holePoints)
+        {
+            outPoints.Add(toAreaSpace.TransformPosition(holePoint));
+        }
+    }
 }
 
-/// <summary>
-/// Checks if this is a valid point
-/// </summary>
-/// <param name="t1"> first point </param>
-/// <param name="t2"> second point </param>
-/// <param name="t3"> third point </param>
-inline bool IsPointInTriangle(FVector t1, FVector t2, FVector t3, FVector p)
+void ASplineArea::GetHoleSplines(TArray<USplineComponent*>& outHoleSplines) const
+{
+    GetComponents<USplineComponent>(outHoleSplines);
+    outHoleSplines.Remove(pSpline);
+}
+
+bool ASplineArea::RetriangulateChangedPoints(const TArray<FVector>& splinePoints, bool& bOutIndicesChanged)
 {
-    //Get two edges of the triangle and the line to the point
-    const FVector v1 = t3 - t1;
-    const FVector v2 = t2 - t1;
-    const FVector v3 = p - t1;
+    SPLINEAREA_SCOPE(RetriangulateChangedPoints);
+
+    const int oldPointCount = AreaVertices.Num();
+    const int newPointCount = splinePoints.Num();
+    if (AreaIndices.Num() == 0 || bAreaSelfIntersecting || newPointCount < 3 || FMath::Abs(newPointCount - oldPointCount) > 1)
+        return false;
+
+    //Find the first and last point that differ, a single edit touches exactly one point
+    const int sharedCount = FMath::Min(oldPointCount, newPointCount);
+    int firstChanged = 0;
+    while (firstChanged < sharedCount && splinePoints[firstChanged] == AreaVertices[firstChanged])
+    {
+        firstChanged++;
+    }
+    int lastChangedFromEnd = 0;
+    while (lastChangedFromEnd < sharedCount - firstChanged &&
+        splinePoints[newPointCount - 1 - lastChangedFromEnd] == AreaVertices[oldPointCount - 1 - lastChangedFromEnd])
+    {
+        lastChangedFromEnd++;
+    }
+
+    const int changedCount = newPointCount - firstChanged - lastChangedFromEnd;
+    if (newPointCount == oldPointCount && changedCount == 0)
+    {
+        bOutIndicesChanged = false;
+        return true;
+    }
+
+    std::vector<SplineAreaGeometry::Vector3> points;
+    points.reserve(newPointCount);
+    for (const FVector& splinePoint : splinePoints)
+    {
+        points.push_back(ToGeometryVector(splinePoint));
+    }
+    std::vector<int> indices(AreaIndices.GetData(), AreaIndices.GetData() + AreaIndices.Num());
+    if (bAreaAdjacencyDirty)
+    {
+        AreaAdjacency.Build(oldPointCount, indices);
+        bAreaAdjacencyDirty = false;
+    }
 
-    //Convert the triangle edges to a Barycentric Coordinate System
-    const float daa = FVector::DotProduct(v1, v1);
-    const float dab = FVector::DotProduct(v1, v2);
-    const float dac = FVector::DotProduct(v1, v3);
-    const float dbb = FVector::DotProduct(v2, v2);
-    const float dbc = FVector::DotProduct(v2, v3);
+    bool bSucceeded = false;
+    if (newPointCount == oldPointCount && changedCount == 1)
+        bSucceeded = SplineAreaGeometry::RetriangulateMovedPoint(points, firstChanged, indices, AreaAdjacency);
+    else if (newPointCount == oldPointCount + 1 && changedCount == 1)
+        bSucceeded = SplineAreaGeometry::RetriangulateInsertedPoint(points, firstChanged, indices, AreaAdjacency);
+    else if (newPointCount == oldPointCount - 1 && changedCount == 0)
+        bSucceeded = SplineAreaGeometry::RetriangulateRemovedPoint(points, firstChanged, indices, AreaAdjacency);
 
-    float u = (((dbb * dac) - (dab * dbc)) / ((daa * dbb) - (dab * dab)));
-    float v = (((daa * dbc) - (dab * dac)) / ((daa * dbb) - (dab * dab)));
+    if (!bSucceeded)
+        return false;
 
-    //If the position of the point in the barycentric coord sys is greater than 1 is is not inside the triangle
-    return (v >= 0.f) && (u >= 0.f) && ((u + v) < 1.f);
+    bOutIndicesChanged = newPointCount != oldPointCount || FMemory::Memcmp(
+        indices.data(), AreaIndices.GetData(), indices.size() * sizeof(int)) != 0;
+    AreaVertices = splinePoints;
+    bAreaQueryDirty = true;
+    bAreaBoundsDirty = true;
+    AreaIndices.Reset(indices.size());
+    AreaIndices.Append(indices.data(), indices.size());
+    return true;
 }
 
-/// <summary>
-/// Check if any reflex points are inside the triangle created by the 3 points if so it is an ear
-/// </summary>
-/// <param name="curPointIndex"> Point index that you want to check </param>
-/// <param name="reflexIndices"> Array that contains all the known reflex indices </param>
-/// <param name="splinePoints"> Array that contains all the spline points positional data </param>
-inline bool IsPointAnEar(const int curPointIndex, const TArray<int>& reflexIndices, const TArray<FVector>& splinePoints)
+void ASplineArea::UpdateAreaQuery() const
 {
-    bool IsEar = true;
-
-    const int prevIndex = CircularIndex(curPointIndex - 1, splinePoints.Num());
-    const int nextIndex = CircularIndex(curPointIndex + 1, splinePoints.Num());
+    if (!bAreaQueryDirty)
+        return;
+    bAreaQueryDirty = false;
 
-    const FVector curPoint = splinePoints[curPointIndex];
-    const FVector prevPoint = splinePoints[prevIndex];
-    const FVector nextPoint = splinePoints[nextIndex];
+    SPLINEAREA_SCOPE(UpdateAreaQuery);
 
-    for (auto i = 0; i < reflexIndices.Num(); i++)
+    std::vector<SplineAreaGeometry::Vector3> points;
+    points.reserve(AreaVertices.Num());
+    for (const FVector& areaVertex : AreaVertices)
     {
-        IsEar = !IsPointInTriangle(curPoint, prevPoint, nextPoint, splinePoints[reflexIndices[i]]);
-        if (!IsEar)
-            return IsEar;
+        points.push_back(ToGeometryVector(areaVertex));
     }
-    return IsEar;
+    const std::vector<int> indices(AreaIndices.GetData(), AreaIndices.GetData() + AreaIndices.Num());
+    const std::vector<int> holeStarts(AreaHoleStarts.GetData(), AreaHoleStarts.GetData() + AreaHoleStarts.Num());
+    AreaQuery.Build(points, indices, holeStarts);
 }
 
-void ASplineArea::TriangulateSpline()
+bool ASplineArea::IsLocationInArea(const FVector& location, const float heightTolerance) const
 {
-    TArray<FVector> splinePoints = GetSplinePoints();
-    TArray<FVector> reflexPoints = TArray<FVector>{};
-    TArray<FVector> convexPoints = TArray<FVector>{};
-    TArray<FVector> earPoints = TArray<FVector>{};
+    UpdateAreaQuery();
 
-    TArray<int> reflexIndices = TArray<int>{};
-    TArray<int> convexIndices = TArray<int>{};
-    TArray<int> earIndices = TArray<int>{};
+    //The area vertices are local to the spline, points outside the bounds of the area get rejected by the grid
+    const FVector localLocation = pSpline->GetComponentTransform().InverseTransformPosition(location);
+    float areaHeight = 0.f;
+    if (AreaQuery.FindTriangle(localLocation.X, localLocation.Y, areaHeight) == INDEX_NONE)
+        return false;
 
-    GetPolygonComponents(splinePoints, reflexPoints, convexPoints, earPoints, reflexIndices, convexIndices, earIndices);
+    return FMath::Abs(localLocation.Z - areaHeight) <= heightTolerance;
+}
 
-    reflexPoints.Reset();
-    convexPoints.Reset();
-    earPoints.Reset();
+void ASplineArea::AreLocationsInArea(const TArray<FVector>& locations, TArray<bool>& outResults,
+                                     const float heightTolerance) const
+{
+    UpdateAreaQuery();
 
-    TrianglesFromPoints(splinePoints, convexIndices, reflexIndices, earIndices);
+    const FTransform& splineTransform = pSpline->GetComponentTransform();
+    outResults.SetNumUninitialized(locations.Num());
+    for (int i = 0; i < locations.Num(); i++)
+    {
+        const FVector localLocation = splineTransform.InverseTransformPosition(locations[i]);
+        float areaHeight = 0.f;
+        outResults[i] = AreaQuery.FindTriangle(localLocation.X, localLocation.Y, areaHeight) != INDEX_NONE &&
+            FMath::Abs(localLocation.Z - areaHeight) <= heightTolerance;
+    }
 }
 
-void ASplineArea::GetPolygonComponents(const TArray<FVector>& splinePoints, TArray<FVector>& reflexPoints,
-                                       TArray<FVector>& convexPoints, TArray<FVector>&
-                                       earPoints, TArray<int>& reflexIndices, TArray<int>& convexIndices,
-                                       TArray<int>& earIndices) const
+bool ASplineArea::FindNearestPointInArea(const FVector& location, FVector& outNearestLocation) const
 {
-    //Testing if point is convex or reflex
+    UpdateAreaQuery();
+
+    const FTransform& splineTransform = pSpline->GetComponentTransform();
+    const FVector localLocation = splineTransform.InverseTransformPosition(location);
+    SplineAreaGeometry::Vector3 nearestPoint;
+    if (!AreaQuery.FindNearestPoint(localLocation.X, localLocation.Y, nearestPoint))
+        return false;
+
+    outNearestLocation = splineTransform.TransformPosition(FVector(nearestPoint.X, nearestPoint.Y, nearestPoint.Z));
+    return true;
+}
+
+TArray<FVector> ASplineArea::GetSplinePoints() const
+{
+    TArray<FVector> splinePoints;
+    const int pointCount = pSpline->GetNumberOfSplinePoints();
+    if (bCurvedArea && pointCount >= 2)
     {
-        FVector prevPoint = FVector();
-        FVector nextPoint = FVector();
-        for (int curIndex = 0; curIndex < splinePoints.Num(); curIndex++)
+        for (int i = 0; i < pointCount; i++)
         {
-            FVector curPoint = splinePoints[curIndex];
-            const int prevIndex = CircularIndex(curIndex - 1, splinePoints.Num());
-            prevPoint = splinePoints[prevIndex];
-            const int nextIndex = CircularIndex(curIndex + 1, splinePoints.Num());
-            nextPoint = splinePoints[nextIndex];
-
-            if (PointIsConvex(prevPoint, curPoint, nextPoint))
-            {
-                convexPoints.Add(curPoint);
-                convexIndices.Add(curIndex);
-            }
-            else
-            {
-                reflexPoints.Add(curPoint);
-                reflexIndices.Add(curIndex);
-            }
+            FlattenSplineSegment(pSpline, i, FMath::Max(CurveTolerance, 0.1f), splinePoints);
         }
+        return splinePoints;
     }
 
-    //Testing if point is an ear
+    splinePoints.Reserve(pointCount);
+    for (int i = 0; i < pointCount; i++)
     {
-        for (int curIndex = 0; curIndex < convexIndices.Num(); curIndex++)
-        {
-            int curElement = convexIndices[curIndex];
+        splinePoints.Add(pSpline->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::Local));
+    }
+    return splinePoints;
+}
 
-            if (IsPointAnEar(curElement, reflexIndices, splinePoints))
-            {
-                earPoints.Add(splinePoints[curElement]);
-                earIndices.Add(curElement);
-            }
-        }
+const TArray<FVector>& ASplineArea::GetAreaVertices() const
+{
+    return AreaVertices;
+}
+
+const TArray<int32>& ASplineArea::GetAreaHoleStarts() const
+{
+    return AreaHoleStarts;
+}
+
+const TArray<int32>& ASplineArea::GetAreaIndices() const
+{
+    return AreaIndices;
+}
+
+const TArray<FVector2D>& ASplineArea::GetAreaUVs() const
+{
+    //The streams are not saved, an area restored from the cache fills them on first use
+    if (MeshUVs.Num() != AreaVertices.Num())
+        UpdateMeshStreams();
+    return MeshUVs;
+}
+
+const TArray<FTransform>& ASplineArea::GetOutlineTransforms() const
+{
+    return CachedOutlineTransforms;
+}
+
+FTransform ASplineArea::GetAreaMeshTransform() const
+{
+    return pAreaMesh->GetComponentTransform();
+}
+
+FTransform ASplineArea::GetAreaOutlineTransform() const
+{
+    return pAreaOutline->GetComponentTransform();
+}
+
+UMaterialInterface* ASplineArea::GetAreaMeshMaterial() const
+{
+    return pAreaMeshMaterial;
+}
+
+UMaterialInterface* ASplineArea::GetAreaOutlineMaterial() const
+{
+    return pAreaOutlineMaterial;
+}
+
+UStaticMesh* ASplineArea::GetAreaOutlineMesh() const
+{
+    return pAreaOutline->GetStaticMesh();
+}
+
+float ASplineArea::GetAreaOutlineWidth() const
+{
+    return bEnableOutline ? OutlineWidth : 0.f;
+}
+
+float ASplineArea::GetAreaUVTileSize() const
+{
+    return FMath::Max(AreaUVTileSize, 1.f);
+}
+
+bool ASplineArea::ShouldMergeOverlappingAreas() const
+{
+    return bMergeOverlappingAreas;
+}
+
+void ASplineArea::CreateAreaMesh() const
+{
+    //A released area only keeps the generated data, the section gets made once it is relevant again
+    if (!bAreaResident)
+        return;
+
+    if (pAreaMesh->GetMaterial(0) != pAreaMeshMaterial)
+        pAreaMesh->SetMaterial(0, pAreaMeshMaterial);
+
+    //Same triangles as the section already has, so only the vertex buffer needs to change
+    const FProcMeshSection* meshSection = pAreaMesh->GetProcMeshSection(0);
+    if (meshSection != nullptr && meshSection->ProcVertexBuffer.Num() == AreaVertices.Num() &&
+        meshSection->ProcIndexBuffer.Num() == AreaIndices.Num() && AreaIndices.Num() > 0 &&
+        FMemory::Memcmp(meshSection->ProcIndexBuffer.GetData(), AreaIndices.GetData(), AreaIndices.Num() * sizeof(int32)) == 0)
+    {
+        UpdateAreaMeshVertices();
+        return;
     }
+
+    SPLINEAREA_SCOPE(CreateAreaMesh);
+    UpdateMeshStreams();
+    const bool bTriangleCollision = CollisionMode == ESplineAreaCollision::Triangles;
+    pAreaMesh->CreateMeshSection(0, AreaVertices, AreaIndices, MeshNormals, MeshUVs, MeshColors, MeshTangents, bTriangleCollision);
+    UpdateAreaCollision();
+    MarkBatchDirty();
 }
 
-void ASplineArea::TrianglesFromPoints(TArray<FVector>& splinePoints, const TArray<int>& inConvexIndices,
-                                      const TArray<int>& inReflexIndices, const TArray<
-                                          int>& inEarIndices)
+void ASplineArea::UpdateAreaMeshVertices() const
 {
-    int curPoint = 0;
-    if (inEarIndices.Num() > 0)
-        curPoint = inEarIndices[0];
-    const int prevPoint = CircularIndex(curPoint - 1, splinePoints.Num());
-    const int nextPoint = CircularIndex(curPoint + 1, splinePoints.Num());
+    if (!bAreaResident)
+        return;
+
+    SPLINEAREA_SCOPE(CreateAreaMesh);
+    UpdateMeshStreams();
 
-    if (splinePoints.Num() <= 3)
+    //Streams that are left empty keep their current data on the section
+    pAreaMesh->UpdateMeshSection(0, AreaVertices, TArray<FVector>(), MeshUVs, TArray<FColor>(), TArray<FProcMeshTangent>());
+    UpdateAreaCollision();
+    MarkBatchDirty();
+}
+
+void ASplineArea::UpdateAreaCollision() const
+{
+    FProcMeshSection* meshSection = pAreaMesh->GetProcMeshSection(0);
+    if (meshSection == nullptr)
+        return;
+
+    SPLINEAREA_SCOPE(UpdateAreaCollision);
+    if (CollisionMode == ESplineAreaCollision::Triangles)
     {
-        MeshTriangle triangle;
-        triangle.point1 = splinePoints[0];
-        triangle.point2 = splinePoints[1];
-        triangle.point3 = splinePoints[2];
-        VisualizationTriangles.Add(triangle);
+        //Clearing the convex pieces also recooks the triangles
+        if (!meshSection->bEnableCollision || !pAreaMesh->bUseComplexAsSimpleCollision)
+        {
+            meshSection->bEnableCollision = true;
+            pAreaMesh->bUseComplexAsSimpleCollision = true;
+            pAreaMesh->ClearCollisionConvexMeshes();
+        }
+        return;
     }
-    else
+
+    meshSection->bEnableCollision = false;
+    pAreaMesh->bUseComplexAsSimpleCollision = false;
+
+    std::vector<SplineAreaGeometry::Vector3> points;
+    points.reserve(AreaVertices.Num());
+    for (const FVector& areaVertex : AreaVertices)
     {
-        //Make a triangle of the ear point and its adjacent points
-        MeshTriangle triangle;
-        triangle.point1 = splinePoints[curPoint];
-        triangle.point2 = splinePoints[prevPoint];
-        triangle.point3 = splinePoints[nextPoint];
+        points.push_back(ToGeometryVector(areaVertex));
+    }
+    const std::vector<int> indices(AreaIndices.GetData(), AreaIndices.GetData() + AreaIndices.Num());
 
-        //Remove the ear
-        splinePoints.RemoveAt(curPoint);
+    //Pieces of up to 64 points give hulls of 128 vertices, which every physics backend cooks without reducing them
+    std::vector<std::vector<int>> pieces;
+    SplineAreaGeometry::ConvexPartition(points, indices, 64, pieces);
 
-        //Recalcualte the polygon components with the ear missing for an optimisation a linked list data structure can be used instead of recalculating at every step
-        TArray<FVector> reflexPoints = TArray<FVector>{};
-        TArray<FVector> convexPoints = TArray<FVector>{};
-        TArray<FVector> earPoints = TArray<FVector>{};
-        TArray<int> reflexIndices = TArray<int>{};
-        TArray<int> convexIndices = TArray<int>{};
-        TArray<int> earIndices = TArray<int>{};
-        GetPolygonComponents(splinePoints, reflexPoints, convexPoints, earPoints, reflexIndices, convexIndices,
-                             earIndices);
-        TrianglesFromPoints(splinePoints, convexIndices, reflexIndices, earIndices);
-        VisualizationTriangles.Add(triangle);
+    const FVector thickness(0.f, 0.f, FMath::Max(CollisionThickness, 0.1f));
+    TArray<TArray<FVector>> convexMeshes;
+    convexMeshes.Reserve(pieces.size());
+    for (const std::vector<int>& piece : pieces)
+    {
+        TArray<FVector>& convexMesh = convexMeshes.AddDefaulted_GetRef();
+        convexMesh.Reserve(piece.size() * 2);
+        for (const int pointIndex : piece)
+        {
+            convexMesh.Add(AreaVertices[pointIndex]);
+            convexMesh.Add(AreaVertices[pointIndex] - thickness);
+        }
     }
+    pAreaMesh->SetCollisionConvexMeshes(convexMeshes);
 }
 
-TArray<FVector> ASplineArea::GetSplinePoints() const
+void ASplineArea::UpdateMeshStreams() const
 {
-    TArray<FVector> splinePoints;
-    for (int i = 0; i < pSpline->GetNumberOfSplinePoints(); i++)
+    const int vertexCount = AreaVertices.Num();
+
+    //Planar projection, the area is flat enough that the stretch on slopes is not visible
+    const float uvScale = 1.f / FMath::Max(AreaUVTileSize, 1.f);
+    MeshUVs.SetNumUninitialized(vertexCount, false);
+    for (int i = 0; i < vertexCount; i++)
     {
-        splinePoints.Add(pSpline->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::Local));
+        MeshUVs[i] = FVector2D(AreaVertices[i].X * uvScale, AreaVertices[i].Y * uvScale);
     }
-    return splinePoints;
-}
 
-void ASplineArea::TrianglesToIndices(const TArray<MeshTriangle>& triangles, TArray<FVector>& vertices,
-                                     TArray<int>& indices) const
-{
-    for (int i = 0; i < triangles.Num(); i++)
+    if (bSkipConstantVertexStreams)
     {
-        int newIndex = vertices.AddUnique(triangles[i].point1);
-        if (newIndex < 0)
-            indices.Add(newIndex);
-        else
-            indices.Add(vertices.Find(triangles[i].point1));
+        MeshNormals.Reset();
+        MeshTangents.Reset();
+        MeshColors.Reset();
+        return;
+    }
 
-        vertices.AddUnique(triangles[i].point2);
-        if (newIndex < 0)
-            indices.Add(newIndex);
-        else
-            indices.Add(vertices.Find(triangles[i].point2));
+    //Every vertex gets the same value, so the streams only need writing when they changed size
+    if (MeshNormals.Num() == vertexCount)
+        return;
 
-        vertices.AddUnique(triangles[i].point3);
-        if (newIndex < 0)
-            indices.Add(newIndex);
-        else
-            indices.Add(vertices.Find(triangles[i].point3));
+    MeshNormals.SetNumUninitialized(vertexCount, false);
+    MeshTangents.SetNumUninitialized(vertexCount, false);
+    MeshColors.SetNumUninitialized(vertexCount, false);
+    for (int i = 0; i < vertexCount; i++)
+    {
+        MeshNormals[i] = FVector(0, 0, 1);
+        MeshTangents[i] = FProcMeshTangent(0, 0, 1);
+        MeshColors[i] = FColor(0.75, 0.75, 0.75, 1.0);
     }
 }
 
-void ASplineArea::CreateAreaMesh() const
+void ASplineArea::CreateAreaOutline()
 {
-    TArray<FVector> vertices;
-    TArray<int> indices;
-    TrianglesToIndices(VisualizationTriangles, vertices, indices);
+    //The spline points are local to the actor, so are the outline instances
+    CachedOutlineTransforms.Reset();
+    if (bEnableOutline)
+        BuildOutlineTransforms(AreaVertices, AreaHoleStarts, OutlineWidth, CachedOutlineTransforms);
+
+    ApplyAreaOutline(CachedOutlineTransforms);
+}
 
-    TArray<FVector> normals;
-    for (int i = 0; i < vertices.Num(); i++)
+void ASplineArea::CreateAreaLODs()
+{
+    if (!bAreaResident)
+        return;
+
+    SPLINEAREA_SCOPE(CreateAreaLODs);
+
+    //Sections of LODs that got removed since the last build
+    for (int section = AreaLODs.Num() + 1; section < pAreaMesh->GetNumSections(); section++)
     {
-        normals.Add(FVector(0, 0, 1));
+        pAreaMesh->ClearMeshSection(section);
     }
-    TArray<FVector2D> uv;
-    for (int i = 0; i < vertices.Num(); i++)
+
+    if (CurrentLOD != 0)
     {
-        uv.Add(FVector2D(0, 0));
+        pAreaMesh->SetMeshSectionVisible(0, true);
+        CurrentLOD = 0;
     }
-    TArray<FProcMeshTangent> tangents;
-    for (int i = 0; i < vertices.Num(); i++)
+
+    LODData.SetNum(AreaLODs.Num());
+    if (AreaLODs.Num() == 0 || AreaVertices.Num() < 3)
+        return;
+
+    //The constant streams hold the same value for every vertex, so the first part of them fits any LOD
+    const TArray<FVector2D>& areaUVs = GetAreaUVs();
+    const bool bConstantStreams = !bSkipConstantVertexStreams && MeshNormals.Num() == AreaVertices.Num();
+
+    std::vector<SplineAreaGeometry::Vector3> points;
+    std::vector<int> keptIndices;
+    TArray<FVector2D> lodUVs;
+    TArray<int32> lodHoleStarts;
+
+    //Simplifies the outline and every hole on their own, holes that collapse get left out. Returns false when the simplified
+    //loops cross themselves or each other
+    auto buildLOD = [&](FSplineAreaLODData& lod, const float maxError)
     {
-        tangents.Add(FProcMeshTangent(0, 0, 1));
+        lod.Vertices.Reset();
+        lod.Indices.Reset();
+        lodUVs.Reset();
+        lodHoleStarts.Reset();
+        for (int loop = 0; loop <= AreaHoleStarts.Num(); loop++)
+        {
+            const int begin = loop > 0 ? AreaHoleStarts[loop - 1] : 0;
+            const int end = loop < AreaHoleStarts.Num() ? AreaHoleStarts[loop] : AreaVertices.Num();
+            points.clear();
+            for (int i = begin; i < end; i++)
+            {
+                points.push_back(ToGeometryVector(AreaVertices[i]));
+            }
+
+            SplineAreaGeometry::SimplifyPolygon(points, maxError, keptIndices);
+            if (loop > 0)
+            {
+                if (keptIndices.size() < 3)
+                    continue;
+                lodHoleStarts.Add(lod.Vertices.Num());
+            }
+            for (const int keptIndex : keptIndices)
+            {
+                lod.Vertices.Add(AreaVertices[begin + keptIndex]);
+                lodUVs.Add(areaUVs[begin + keptIndex]);
+            }
+        }
+        return TriangulatePoints(lod.Vertices, lodHoleStarts, lod.Indices);
+    };
+
+    //Error budget of the last LOD that came out clean, zero keeps every corner of the full area
+    float cleanMaxError = 0.f;
+    for (int lodIndex = 0; lodIndex < AreaLODs.Num(); lodIndex++)
+    {
+        FSplineAreaLODData& lod = LODData[lodIndex];
+        lod.OutlineTransforms.Reset();
+
+        //Douglas-Peucker does not keep the loops apart, a budget that makes them cross gets halved a few times before the
+        //LOD falls back to the previous one
+        float maxError = AreaLODs[lodIndex].MaxError;
+        bool bClean = buildLOD(lod, maxError);
+        for (int attempt = 0; attempt < 3 && !bClean; attempt++)
+        {
+            maxError *= 0.5f;
+            bClean = buildLOD(lod, maxError);
+        }
+        if (bClean)
+            cleanMaxError = maxError;
+        else
+            buildLOD(lod, cleanMaxError);
+
+        if (bEnableOutline)
+            BuildOutlineTransforms(lod.Vertices, lodHoleStarts, OutlineWidth, lod.OutlineTransforms);
+
+        const int vertexCount = lod.Vertices.Num();
+        const int section = lodIndex + 1;
+        pAreaMesh->CreateMeshSection(section, lod.Vertices, lod.Indices,
+                                     bConstantStreams ? TArray<FVector>(MeshNormals.GetData(), vertexCount) : TArray<FVector>(),
+                                     lodUVs,
+                                     bConstantStreams ? TArray<FColor>(MeshColors.GetData(), vertexCount) : TArray<FColor>(),
+                                     bConstantStreams
+                                         ? TArray<FProcMeshTangent>(MeshTangents.GetData(), vertexCount)
+                                         : TArray<FProcMeshTangent>(), false);
+        pAreaMesh->SetMaterial(section, pAreaMeshMaterial);
+        pAreaMesh->SetMeshSectionVisible(section, false);
     }
-    TArray<FColor> vertexColors;
-    for (int i = 0; i < vertices.Num(); i++)
+}
+
+void ASplineArea::UpdateAreaLOD()
+{
+    if (!bAreaResident)
+        return;
+
+    const APlayerCameraManager* cameraManager = UGameplayStatics::GetPlayerCameraManager(this, 0);
+    if (cameraManager == nullptr)
+        return;
+
+    //Same measure as the screen size of static mesh LODs, the projected diameter of the bounds against the screen height
+    const FBoxSphereBounds& bounds = pAreaMesh->Bounds;
+    const float distance = FMath::Max(FVector::Dist(bounds.Origin, cameraManager->GetCameraLocation()), 1.f);
+    const float halfFov = FMath::DegreesToRadians(FMath::Clamp(cameraManager->GetFOVAngle(), 1.f, 170.f) * 0.5f);
+    const float screenSize = bounds.SphereRadius / (distance * FMath::Tan(halfFov));
+
+    int32 lodIndex = 0;
+    while (lodIndex < AreaLODs.Num() && screenSize < AreaLODs[lodIndex].ScreenSize)
     {
-        vertexColors.Add(FColor(0.75, 0.75, 0.75, 1.0));
+        lodIndex++;
     }
+    SetAreaLOD(lodIndex);
+}
+
+void ASplineArea::SetAreaLOD(int32 lodIndex)
+{
+    lodIndex = FMath::Clamp(lodIndex, 0, LODData.Num());
+    if (lodIndex == CurrentLOD)
+        return;
+
+    pAreaMesh->SetMeshSectionVisible(lodIndex, true);
+    pAreaMesh->SetMeshSectionVisible(CurrentLOD, false);
+    CurrentLOD = lodIndex;
 
-    pAreaMesh->ClearMeshSection(0);
-    pAreaMesh->CreateMeshSection(0, vertices, indices, normals, uv, vertexColors, tangents, true);
-    pAreaMesh->SetMaterial(0, pAreaMeshMaterial);
+    //Only the instances change, the outline keeps the visibility SetAreaActive gave it
+    if (bEnableOutline && !bRegisteredInBatch)
+        ApplyInstanceTransforms(pAreaOutline, lodIndex == 0 ? CachedOutlineTransforms : LODData[lodIndex - 1].OutlineTransforms);
 }
 
-void ASplineArea::CreateAreaOutline() const
+int32 ASplineArea::GetAreaLOD() const
 {
-    if (bEnableOutline == false)
+    return CurrentLOD;
+}
+
+void ASplineArea::ApplyAreaOutline(const TArray<FTransform>& outlineTransforms) const
+{
+    if (!bAreaResident)
+        return;
+
+    //Instances are kept while the area is inactive, SetAreaActive only flips the visibility
+    const bool bShowOutline = bEnableOutline && !bRegisteredInBatch;
+    pAreaOutline->SetVisibility(bShowOutline && bAreaActive);
+    if (bShowOutline)
+        ApplyInstanceTransforms(pAreaOutline, outlineTransforms);
+    else
+        ApplyInstanceTransforms(pAreaOutline, TArray<FTransform>());
+
+    MarkBatchDirty();
+}
+
+void ASplineArea::ApplyInstanceTransforms(UInstancedStaticMeshComponent* instancedMesh, const TArray<FTransform>& transforms)
+{
+    SPLINEAREA_SCOPE(CreateAreaOutline);
+
+    const int targetCount = transforms.Num();
+    const int currentCount = instancedMesh->GetInstanceCount();
+
+    //Existing instance slots are kept, only the difference in count gets added or removed at the end
+    if (targetCount == 0)
     {
-        pAreaOutline->ClearInstances();
-        pAreaOutline->SetVisibility(false);
+        if (currentCount > 0)
+            instancedMesh->ClearInstances();
         return;
     }
+    if (currentCount > targetCount)
+    {
+        TArray<int32> removedInstances;
+        removedInstances.Reserve(currentCount - targetCount);
+        for (int i = currentCount - 1; i >= targetCount; i--)
+        {
+            removedInstances.Add(i);
+        }
+        instancedMesh->RemoveInstances(removedInstances);
+    }
+    else if (currentCount < targetCount)
+    {
+        const TArray<FTransform> addedTransforms(transforms.GetData() + currentCount, targetCount - currentCount);
+        instancedMesh->AddInstances(addedTransforms, false);
+    }
 
-    pAreaOutline->ClearInstances();
-    pAreaOutline->SetVisibility(true);
+    //One batched write for every slot that existed before, the render state gets marked dirty once
+    if (currentCount > 0)
+    {
+        if (currentCount >= targetCount)
+        {
+            instancedMesh->BatchUpdateInstancesTransforms(0, transforms, false, true, true);
+        }
+        else
+        {
+            const TArray<FTransform> keptTransforms(transforms.GetData(), currentCount);
+            instancedMesh->BatchUpdateInstancesTransforms(0, keptTransforms, false, true, true);
+        }
+    }
+}
+
+void ASplineArea::BuildOutlineTransforms(const TArray<FVector>& splinePoints, const TArray<int32>& holeStarts,
+                                         const float outlineWidth, TArray<FTransform>& outTransforms)
+{
+    SPLINEAREA_SCOPE(CreateAreaOutline);
 
-    const int instanceCount = pSpline->GetNumberOfSplinePoints();
+    //One instance per edge, every loop closes on its own first point
+    const int instanceCount = splinePoints.Num();
+    outTransforms.Reserve(outTransforms.Num() + instanceCount);
+    int loop = 0;
+    int loopStart = 0;
     for (int i = 0; i < instanceCount; i++)
     {
-        FVector firstPoint = pSpline->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::World);
-        FVector secondPoint = pSpline->GetLocationAtSplinePoint(
-            CircularIndex(i + 1, pSpline->GetNumberOfSplinePoints()), ESplineCoordinateSpace::World);
-        const FRotator rotationToPoint = UKismetMathLibrary::FindLookAtRotation(firstPoint, secondPoint);
-        const float length = FVector::Dist(firstPoint, secondPoint);
+        if (loop < holeStarts.Num() && i == holeStarts[loop])
+        {
+            loopStart = i;
+            loop++;
+        }
+        const int loopEnd = loop < holeStarts.Num() ? holeStarts[loop] : instanceCount;
+
+        const FVector& firstPoint = splinePoints[i];
+        const FVector& secondPoint = splinePoints[i + 1 < loopEnd ? i + 1 : loopStart];
+        const FVector edge = secondPoint - firstPoint;
+        const FRotator rotationToPoint = edge.Rotation();
+        const float length = edge.Size();
 
         FTransform newTransform;
         newTransform.SetLocation(FMath::Lerp(firstPoint, secondPoint, 0.5f));
         newTransform.SetRotation(FQuat(FRotator(rotationToPoint.Pitch, rotationToPoint.Yaw, 1.f)));
-        newTransform.SetScale3D(FVector(length * 0.005f, OutlineWidth, 1.f));
-
-        pAreaOutline->AddInstanceWorldSpace(newTransform);
+        newTransform.SetScale3D(FVector(length * 0.005f, outlineWidth, 1.f));
+        outTransforms.Add(newTransform);
     }
 }
 
-void ASplineArea::SetAreaActive(bool newState) const
+void ASplineArea::MarkBatchDirty() const
+{
+    if (!bRegisteredInBatch)
+        return;
+
+    if (USplineAreaSubsystem* subsystem = GetWorld()->GetSubsystem<USplineAreaSubsystem>())
+        subsystem->MarkAreaDirty(this);
+}
+
+void ASplineArea::SetAreaActive(const bool newState)
+{
+    bAreaActive = newState;
+
+    //A released area has nothing to show or hide, the state gets applied when its resources are created again. Otherwise
+    //the state always gets pushed, something else may have changed the components. The component setters and the batch
+    //return early on an unchanged value, so gameplay toggling an area every frame stays cheap
+    if (bAreaResident)
+        ApplyAreaActiveState();
+}
+
+bool ASplineArea::IsAreaActive() const
+{
+    return bAreaActive;
+}
+
+void ASplineArea::ApplyAreaActiveState() const
 {
     if (pAreaMesh == nullptr)
         return;
     if (pAreaOutline == nullptr)
         return;
 
-    if (newState)
+    //The own components of a batched area only hold collision, its visuals are a range in the batch
+    if (bRegisteredInBatch)
+    {
+        pAreaMesh->SetCollisionEnabled(bAreaActive ? ECollisionEnabled::QueryAndPhysics : ECollisionEnabled::NoCollision);
+        if (USplineAreaSubsystem* subsystem = GetWorld()->GetSubsystem<USplineAreaSubsystem>())
+            subsystem->SetAreaVisible(this, bAreaActive && bAreaResident);
+        return;
+    }
+
+    if (bAreaActive)
     {
         pAreaMesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
         pAreaMesh->SetVisibility(true);
-        pAreaOutline->SetVisibility(true);
+        pAreaOutline->SetVisibility(bEnableOutline);
     }
     else
     {
@@ -423,3 +1210,103 @@ void ASplineArea::SetAreaActive(bool newState) const
         pAreaOutline->SetVisibility(false);
     }
 }
+
+void ASplineArea::SetRelevanceSource(AActor* source)
+{
+    RelevanceSource = source;
+}
+
+bool ASplineArea::IsAreaResident() const
+{
+    return bAreaResident;
+}
+
+bool ASplineArea::GetRelevanceLocation(FVector& outLocation) const
+{
+    if (const AActor* source = RelevanceSource.Get())
+    {
+        outLocation = source->GetActorLocation();
+        return true;
+    }
+    if (const APawn* pawn = UGameplayStatics::GetPlayerPawn(this, 0))
+    {
+        outLocation = pawn->GetActorLocation();
+        return true;
+    }
+    if (const APlayerCameraManager* cameraManager = UGameplayStatics::GetPlayerCameraManager(this, 0))
+    {
+        outLocation = cameraManager->GetCameraLocation();
+        return true;
+    }
+    return false;
+}
+
+void ASplineArea::UpdateAreaRelevance()
+{
+    FVector sourceLocation;
+    if (!GetRelevanceLocation(sourceLocation))
+        return;
+
+    if (bAreaBoundsDirty)
+    {
+        AreaLocalBounds = FBox(AreaVertices);
+        bAreaBoundsDirty = false;
+    }
+    if (!AreaLocalBounds.IsValid)
+        return;
+
+    //Measured to the bounds instead of the center, so large areas are ready before the source reaches their middle
+    const FBox worldBounds = AreaLocalBounds.TransformBy(pAreaMesh->GetComponentTransform());
+    const float distanceSquared = worldBounds.ComputeSquaredDistanceToPoint(sourceLocation);
+    if (!bAreaResident && distanceSquared <= FMath::Square(ActivationRadius))
+        CreateAreaResources();
+    else if (bAreaResident && distanceSquared > FMath::Square(ActivationRadius + ReleaseHysteresis))
+        ReleaseAreaResources();
+}
+
+void ASplineArea::CreateAreaResources()
+{
+    if (bAreaResident)
+        return;
+
+    SPLINEAREA_SCOPE(UpdateAreaResources);
+    bAreaResident = true;
+    CreateAreaMesh();
+    ApplyAreaOutline(CachedOutlineTransforms);
+    if (AreaLODs.Num() > 0 && !bRegisteredInBatch)
+        CreateAreaLODs();
+    ApplyAreaActiveState();
+}
+
+void ASplineArea::ReleaseAreaResources()
+{
+    if (!bAreaResident)
+        return;
+
+    SPLINEAREA_SCOPE(UpdateAreaResources);
+    //Cleared first, the rebuild functions skip the components from here on
+    bAreaResident = false;
+
+    pAreaMesh->ClearAllMeshSections();
+    if (CollisionMode == ESplineAreaCollision::ConvexPieces)
+        pAreaMesh->ClearCollisionConvexMeshes();
+    ApplyInstanceTransforms(pAreaOutline, TArray<FTransform>());
+    LODData.Empty();
+    CurrentLOD = 0;
+
+    //The streams and the query grid get filled again on first use
+    MeshUVs.Empty();
+    MeshNormals.Empty();
+    MeshTangents.Empty();
+    MeshColors.Empty();
+    AreaQuery.Reset();
+    bAreaQueryDirty = true;
+    AreaAdjacency.Reset();
+    bAreaAdjacencyDirty = true;
+
+    if (bRegisteredInBatch)
+    {
+        if (USplineAreaSubsystem* subsystem = GetWorld()->GetSubsystem<USplineAreaSubsystem>())
+            subsystem->SetAreaVisible(this, false);
+    }
+}
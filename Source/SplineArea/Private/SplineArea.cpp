@@ -1,18 +1,83 @@
 ﻿// Copyright 2021 Robin Smekens
 
 #include "SplineArea.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CoreDelegates.h"
 
 #define LOCTEXT_NAMESPACE "FSplineAreaModule"
 
+DEFINE_LOG_CATEGORY(LogSplineArea);
+
+DEFINE_STAT(STAT_SplineArea_Triangulate);
+DEFINE_STAT(STAT_SplineArea_PolygonComponents);
+DEFINE_STAT(STAT_SplineArea_TrianglesFromPoints);
+DEFINE_STAT(STAT_SplineArea_RetriangulateChangedPoints);
+DEFINE_STAT(STAT_SplineArea_CreateAreaMesh);
+DEFINE_STAT(STAT_SplineArea_UpdateAreaCollision);
+DEFINE_STAT(STAT_SplineArea_CreateAreaOutline);
+DEFINE_STAT(STAT_SplineArea_CreateAreaLODs);
+DEFINE_STAT(STAT_SplineArea_UpdateAreaResources);
+DEFINE_STAT(STAT_SplineArea_UpdateAreaQuery);
+DEFINE_STAT(STAT_SplineArea_FlushBatches);
+DEFINE_STAT(STAT_SplineArea_RegenerateAllAreas);
+DEFINE_STAT(STAT_SplineArea_MergeAreas);
+
+DEFINE_STAT(STAT_SplineArea_Vertices);
+DEFINE_STAT(STAT_SplineArea_ReflexVertices);
+DEFINE_STAT(STAT_SplineArea_EarIterations);
+DEFINE_STAT(STAT_SplineArea_Triangles);
+DEFINE_STAT(STAT_SplineArea_Allocations);
+DEFINE_STAT(STAT_SplineArea_ScratchBytes);
+DEFINE_STAT(STAT_SplineArea_IncrementalFallbacks);
+DEFINE_STAT(STAT_SplineArea_RebuildsPerSecond);
+
+CSV_DEFINE_CATEGORY_MODULE(SPLINEAREA_API, SplineArea, true);
+
+namespace
+{
+    //Times of the rebuilds within the last second, oldest first
+    TArray<double> GRebuildTimes;
+
+    void RemoveExpiredRebuilds(const double now)
+    {
+        int32 expiredCount = 0;
+        while (expiredCount < GRebuildTimes.Num() && now - GRebuildTimes[expiredCount] > 1.0)
+        {
+            expiredCount++;
+        }
+        GRebuildTimes.RemoveAt(0, expiredCount, false);
+    }
+}
+
+void RecordAreaRebuild()
+{
+    check(IsInGameThread());
+
+    const double now = FPlatformTime::Seconds();
+    RemoveExpiredRebuilds(now);
+    GRebuildTimes.Add(now);
+}
+
 void FSplineAreaModule::StartupModule()
 {
     // This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+    EndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FSplineAreaModule::PublishRebuildRate);
 }
 
 void FSplineAreaModule::ShutdownModule()
 {
     // This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
     // we call this function before unloading the module.
+    FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+    GRebuildTimes.Empty();
+}
+
+void FSplineAreaModule::PublishRebuildRate()
+{
+    //Expired rebuilds are dropped here too, so the rate falls back to zero once the areas stop changing
+    RemoveExpiredRebuilds(FPlatformTime::Seconds());
+    SET_DWORD_STAT(STAT_SplineArea_RebuildsPerSecond, GRebuildTimes.Num());
+    CSV_CUSTOM_STAT(SplineArea, RebuildsPerSecond, GRebuildTimes.Num(), ECsvCustomStatOp::Set);
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,44 @@
+// Copyright 2021 Robin Smekens
+
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "SplineAreaGeometryCorpus.h"
+
+#if !UE_BUILD_SHIPPING
+
+DEFINE_LOG_CATEGORY_STATIC(LogSplineAreaBenchmark, Log, All);
+
+namespace
+{
+    using namespace SplineAreaGeometryCorpus;
+
+    /// <summary>
+    /// Sends the messages of a corpus run to the benchmark log category
+    /// </summary>
+    CorpusLog MakeBenchmarkLog()
+    {
+        CorpusLog log;
+        log.Info = [](const std::string& message)
+        {
+            UE_LOG(LogSplineAreaBenchmark, Display, TEXT("%s"), UTF8_TO_TCHAR(message.c_str()));
+        };
+        log.Error = [](const std::string& message)
+        {
+            UE_LOG(LogSplineAreaBenchmark, Error, TEXT("%s"), UTF8_TO_TCHAR(message.c_str()));
+        };
+        return log;
+    }
+
+    void RunBenchmark()
+    {
+        SplineAreaGeometryCorpus::RunBenchmark(MakeBenchmarkLog());
+    }
+
+    FAutoConsoleCommand GSplineAreaBenchmarkCommand(
+        TEXT("SplineArea.Benchmark"),
+        TEXT("Triangulates a corpus of convex, star, spiral, comb and coastline polygons and logs timings, allocations and ")
+        TEXT("validity. The standalone benchmark executable runs the same corpus"),
+        FConsoleCommandDelegate::CreateStatic(&RunBenchmark));
+}
+
+#endif
@@ -0,0 +1,2107 @@
+// Copyright 2021 Robin Smekens
+
+#include "SplineAreaGeometry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <unordered_map>
+
+namespace SplineAreaGeometry
+{
+    namespace
+    {
+        /// <summary>
+        /// Resizes a scratch buffer, counting the heap allocation when it has to grow past its capacity
+        /// </summary>
+        template <typename T>
+        void ResizeScratchBuffer(std::vector<T>& buffer, const size_t size, int& allocations)
+        {
+            if (size > buffer.capacity())
+                allocations++;
+            buffer.resize(size);
+        }
+
+        /// <summary>
+        /// Fills a scratch buffer with size copies of the value, counting the heap allocation when it has to grow past its capacity
+        /// </summary>
+        template <typename T>
+        void AssignScratchBuffer(std::vector<T>& buffer, const size_t size, const T& value, int& allocations)
+        {
+            if (size > buffer.capacity())
+                allocations++;
+            buffer.assign(size, value);
+        }
+
+        /// <summary>
+        /// Empties a scratch buffer and makes room for size elements, counting the heap allocation when it has to grow
+        /// </summary>
+        template <typename T>
+        void ClearScratchBuffer(std::vector<T>& buffer, const size_t size, int& allocations)
+        {
+            buffer.clear();
+            if (size > buffer.capacity())
+            {
+                allocations++;
+                buffer.reserve(size);
+            }
+        }
+
+        template <typename T>
+        size_t ScratchBufferBytes(const std::vector<T>& buffer)
+        {
+            return buffer.capacity() * sizeof(T);
+        }
+
+        /// <summary>
+        /// Uniform grid over the reflex vertices of a polygon. Every cell keeps a packed copy of the coordinates of its reflex
+        /// vertices so a whole cell can be tested with one batch kernel call. Vertices that turn convex get their coordinates
+        /// set to NaN, which every kernel treats as outside
+        /// </summary>
+        struct ReflexVertexGrid
+        {
+            float MinX = 0.f;
+            float MinY = 0.f;
+            float InvCellSize = 1.f;
+            int CellCountX = 1;
+            int CellCountY = 1;
+
+            //Cell i owns the items from CellStarts[i] up to CellStarts[i + 1]
+            std::vector<int> CellStarts;
+            std::vector<float> ItemX;
+            std::vector<float> ItemY;
+            std::vector<int> ItemOfPoint;
+            std::vector<int> CellFill;
+
+            void Build(const std::vector<Vector3>& points, const std::vector<int>& reflexIndices, int& allocations)
+            {
+                float maxX = points[0].X;
+                float maxY = points[0].Y;
+                MinX = points[0].X;
+                MinY = points[0].Y;
+                for (const Vector3& point : points)
+                {
+                    MinX = std::min(MinX, point.X);
+                    MinY = std::min(MinY, point.Y);
+                    maxX = std::max(maxX, point.X);
+                    maxY = std::max(maxY, point.Y);
+                }
+                const float width = maxX - MinX;
+                const float height = maxY - MinY;
+
+                //Aim for a few reflex vertices per cell so every kernel call gets a full batch
+                const int targetCellCount = std::max(1, static_cast<int>(reflexIndices.size()) / 4);
+                float cellSize = std::sqrt(width * height / targetCellCount);
+                cellSize = std::max(cellSize, std::max(width, height) / targetCellCount);
+                cellSize = std::max(cellSize, 1.e-4f);
+                InvCellSize = 1.f / cellSize;
+                CellCountX = std::min(std::max(static_cast<int>(width * InvCellSize) + 1, 1), 1024);
+                CellCountY = std::min(std::max(static_cast<int>(height * InvCellSize) + 1, 1), 1024);
+
+                //Count the vertices per cell, turn the counts into offsets and then fill the cells
+                AssignScratchBuffer(CellStarts, CellCountX * CellCountY + 1, 0, allocations);
+                for (const int reflexIndex : reflexIndices)
+                {
+                    CellStarts[CellOf(points[reflexIndex]) + 1]++;
+                }
+                for (size_t cell = 1; cell < CellStarts.size(); cell++)
+                {
+                    CellStarts[cell] += CellStarts[cell - 1];
+                }
+
+                ResizeScratchBuffer(ItemX, reflexIndices.size(), allocations);
+                ResizeScratchBuffer(ItemY, reflexIndices.size(), allocations);
+                AssignScratchBuffer(ItemOfPoint, points.size(), -1, allocations);
+                ResizeScratchBuffer(CellFill, CellStarts.size() - 1, allocations);
+                std::copy(CellStarts.begin(), CellStarts.end() - 1, CellFill.begin());
+                for (const int reflexIndex : reflexIndices)
+                {
+                    const Vector3& point = points[reflexIndex];
+                    const int item = CellFill[CellOf(point)]++;
+                    ItemX[item] = point.X;
+                    ItemY[item] = point.Y;
+                    ItemOfPoint[reflexIndex] = item;
+                }
+            }
+
+            void Remove(const int index)
+            {
+                const int item = ItemOfPoint[index];
+                if (item == -1)
+                    return;
+
+                ItemX[item] = std::numeric_limits<float>::quiet_NaN();
+                ItemY[item] = std::numeric_limits<float>::quiet_NaN();
+                ItemOfPoint[index] = -1;
+            }
+
+            size_t ScratchBytes() const
+            {
+                return ScratchBufferBytes(CellStarts) + ScratchBufferBytes(ItemX) + ScratchBufferBytes(ItemY) +
+                    ScratchBufferBytes(ItemOfPoint) + ScratchBufferBytes(CellFill);
+            }
+
+            int CellOf(const Vector3& point) const
+            {
+                return CellY(point.Y) * CellCountX + CellX(point.X);
+            }
+
+            int CellX(const float x) const
+            {
+                return std::min(std::max(static_cast<int>(std::floor((x - MinX) * InvCellSize)), 0), CellCountX - 1);
+            }
+
+            int CellY(const float y) const
+            {
+                return std::min(std::max(static_cast<int>(std::floor((y - MinY) * InvCellSize)), 0), CellCountY - 1);
+            }
+        };
+
+        /// <summary>
+        /// Check if any reflex points are inside the triangle created by the 3 points if not it is an ear
+        /// </summary>
+        /// <param name="prevPointIndex"> Index of the point before the checked point </param>
+        /// <param name="curPointIndex"> Point index that you want to check </param>
+        /// <param name="nextPointIndex"> Index of the point after the checked point </param>
+        /// <param name="reflexGrid"> Grid that contains all the known reflex indices </param>
+        /// <param name="points"> Array that contains all the positional data </param>
+        bool IsPointAnEar(const int prevPointIndex, const int curPointIndex, const int nextPointIndex,
+                          const ReflexVertexGrid& reflexGrid, const std::vector<Vector3>& points)
+        {
+            const Vector3& curPoint = points[curPointIndex];
+            const Vector3& prevPoint = points[prevPointIndex];
+            const Vector3& nextPoint = points[nextPointIndex];
+
+            const float minX = std::min(std::min(curPoint.X, prevPoint.X), nextPoint.X);
+            const float minY = std::min(std::min(curPoint.Y, prevPoint.Y), nextPoint.Y);
+            const float maxX = std::max(std::max(curPoint.X, prevPoint.X), nextPoint.X);
+            const float maxY = std::max(std::max(curPoint.Y, prevPoint.Y), nextPoint.Y);
+
+            //Cells of one row are contiguous, so every row of the bounding box is a single kernel call
+            const int firstCellX = reflexGrid.CellX(minX);
+            const int lastCellX = reflexGrid.CellX(maxX);
+            const int lastCellY = reflexGrid.CellY(maxY);
+            for (int cellY = reflexGrid.CellY(minY); cellY <= lastCellY; cellY++)
+            {
+                const int firstItem = reflexGrid.CellStarts[cellY * reflexGrid.CellCountX + firstCellX];
+                const int endItem = reflexGrid.CellStarts[cellY * reflexGrid.CellCountX + lastCellX + 1];
+                if (AnyPointInTriangleBatch(reflexGrid.ItemX.data() + firstItem, reflexGrid.ItemY.data() + firstItem,
+                                            endItem - firstItem, prevPoint, curPoint, nextPoint))
+                    return false;
+            }
+            return true;
+        }
+
+        /// <summary>
+        /// Squared distance between the point and the closest point on the segment a, b
+        /// </summary>
+        float SegmentDistanceSquared(const Vector3& point, const Vector3& a, const Vector3& b)
+        {
+            const float edgeX = b.X - a.X;
+            const float edgeY = b.Y - a.Y;
+            const float edgeZ = b.Z - a.Z;
+            const float edgeLengthSquared = edgeX * edgeX + edgeY * edgeY + edgeZ * edgeZ;
+            float t = 0.f;
+            if (edgeLengthSquared > 0.f)
+                t = ((point.X - a.X) * edgeX + (point.Y - a.Y) * edgeY + (point.Z - a.Z) * edgeZ) / edgeLengthSquared;
+            t = std::min(std::max(t, 0.f), 1.f);
+
+            const float dx = point.X - (a.X + edgeX * t);
+            const float dy = point.Y - (a.Y + edgeY * t);
+            const float dz = point.Z - (a.Z + edgeZ * t);
+            return dx * dx + dy * dy + dz * dz;
+        }
+
+        /// <summary>
+        /// Hashes the bit pattern of a position so equal positions can be welded in constant time
+        /// </summary>
+        struct VertexHash
+        {
+            size_t operator()(const Vector3& vector) const
+            {
+                //Adding zero turns -0 into +0 so both hash the same, they also compare equal
+                const float components[3] = {vector.X + 0.f, vector.Y + 0.f, vector.Z + 0.f};
+                uint32_t bits[3];
+                std::memcpy(bits, components, sizeof(bits));
+                return (static_cast<size_t>(bits[0]) * 73856093u) ^ (static_cast<size_t>(bits[1]) * 19349663u) ^
+                    (static_cast<size_t>(bits[2]) * 83492791u);
+            }
+        };
+
+        struct VertexEqual
+        {
+            bool operator()(const Vector3& a, const Vector3& b) const
+            {
+                return a.X == b.X && a.Y == b.Y && a.Z == b.Z;
+            }
+        };
+
+        double Orientation(const Vector3& a, const Vector3& b, const Vector3& c)
+        {
+            return (static_cast<double>(b.X) - a.X) * (static_cast<double>(c.Y) - a.Y) -
+                (static_cast<double>(c.X) - a.X) * (static_cast<double>(b.Y) - a.Y);
+        }
+
+        /// <summary>
+        /// Checks if the segments a-b and c-d cross or touch on the XY plane
+        /// </summary>
+        bool SegmentsIntersect(const Vector3& a, const Vector3& b, const Vector3& c, const Vector3& d)
+        {
+            const int o1 = OrientationSign(a, b, c);
+            const int o2 = OrientationSign(a, b, d);
+            const int o3 = OrientationSign(c, d, a);
+            const int o4 = OrientationSign(c, d, b);
+            if (o1 * o2 < 0 && o3 * o4 < 0)
+                return true;
+
+            //Collinear cases only intersect when one end point lies on the other segment
+            auto onSegment = [](const Vector3& p, const Vector3& q, const Vector3& r)
+            {
+                return std::min(p.X, q.X) <= r.X && r.X <= std::max(p.X, q.X) &&
+                    std::min(p.Y, q.Y) <= r.Y && r.Y <= std::max(p.Y, q.Y);
+            };
+            return (o1 == 0 && onSegment(a, b, c)) || (o2 == 0 && onSegment(a, b, d)) ||
+                (o3 == 0 && onSegment(c, d, a)) || (o4 == 0 && onSegment(c, d, b));
+        }
+
+        /// <summary>
+        /// Finds crossing edges of a ring with a Shamos-Hoey sweep. A vertical line sweeps over the edge end points from left to
+        /// right and keeps the edges it cuts ordered from bottom to top. The first crossing always shows up between two edges
+        /// that are next to each other in that order, so only those pairs get tested. Both lists are kept between calls.
+        /// The ring can hold several closed loops, like an outline and its holes, loop i runs from loopStarts[i] up to
+        /// loopStarts[i + 1]
+        /// </summary>
+        struct RingEdgeSweep
+        {
+            struct SweepEvent
+            {
+                float X;
+                float Y;
+                //Edge times two, plus one for the end where the edge leaves the sweep line
+                int Event;
+            };
+
+            std::vector<SweepEvent> Events;
+            std::vector<int> LeftPoints;
+            std::vector<int> RightPoints;
+            std::vector<int> NextEdges;
+            std::vector<int> ActiveEdges;
+
+            bool HasCrossingEdges(const std::vector<Vector3>& points, const std::vector<int>& ring, const int* loopStarts,
+                                  const int loopCount, int& allocations)
+            {
+                const int edgeCount = static_cast<int>(ring.size());
+                ResizeScratchBuffer(LeftPoints, edgeCount, allocations);
+                ResizeScratchBuffer(RightPoints, edgeCount, allocations);
+                ResizeScratchBuffer(NextEdges, edgeCount, allocations);
+                ResizeScratchBuffer(Events, edgeCount * 2, allocations);
+                for (int loop = 0; loop < loopCount; loop++)
+                {
+                    for (int edge = loopStarts[loop]; edge < loopStarts[loop + 1]; edge++)
+                    {
+                        NextEdges[edge] = edge + 1 < loopStarts[loop + 1] ? edge + 1 : loopStarts[loop];
+                    }
+                }
+                for (int edge = 0; edge < edgeCount; edge++)
+                {
+                    //Edge i runs from ring[i] to the next point of its loop, the sweep sees it from its lexicographically smaller end
+                    const int start = ring[edge];
+                    const int end = ring[NextEdges[edge]];
+                    const bool bStartIsLeft = points[start].X < points[end].X ||
+                        (points[start].X == points[end].X && points[start].Y < points[end].Y);
+                    LeftPoints[edge] = bStartIsLeft ? start : end;
+                    RightPoints[edge] = bStartIsLeft ? end : start;
+                    Events[edge * 2] = {points[LeftPoints[edge]].X, points[LeftPoints[edge]].Y, edge * 2};
+                    Events[edge * 2 + 1] = {points[RightPoints[edge]].X, points[RightPoints[edge]].Y, edge * 2 + 1};
+                }
+
+                //Events from left to right, edges enter before others leave at the same spot so touching edges meet
+                std::sort(Events.begin(), Events.end(), [](const SweepEvent& a, const SweepEvent& b)
+                {
+                    if (a.X != b.X)
+                        return a.X < b.X;
+                    if ((a.Event & 1) != (b.Event & 1))
+                        return (a.Event & 1) < (b.Event & 1);
+                    return a.Y < b.Y;
+                });
+
+                //True when edge a lies below edge b where the sweep line cuts both, exact as long as the edges do not cross
+                auto isBelow = [&](const int a, const int b)
+                {
+                    const Vector3& leftA = points[LeftPoints[a]];
+                    const Vector3& leftB = points[LeftPoints[b]];
+                    const Vector3& rightA = points[RightPoints[a]];
+                    const Vector3& rightB = points[RightPoints[b]];
+                    if (leftA.X == leftB.X && leftA.Y == leftB.Y)
+                        return OrientationSign(leftA, rightA, rightB) > 0;
+                    if (leftA.X == leftB.X)
+                        return leftA.Y < leftB.Y;
+
+                    //Compare the edge that started later against the line of the other one, its right point breaks ties
+                    if (leftA.X < leftB.X)
+                    {
+                        int side = OrientationSign(leftA, rightA, leftB);
+                        if (side == 0)
+                            side = OrientationSign(leftA, rightA, rightB);
+                        return side > 0;
+                    }
+                    int side = OrientationSign(leftB, rightB, leftA);
+                    if (side == 0)
+                        side = OrientationSign(leftB, rightB, rightA);
+                    return side < 0;
+                };
+                auto testPair = [&](const int a, const int b)
+                {
+                    if (NextEdges[a] == b || NextEdges[b] == a)
+                        return false;
+
+                    return SegmentsIntersect(points[LeftPoints[a]], points[RightPoints[a]], points[LeftPoints[b]],
+                                             points[RightPoints[b]]);
+                };
+
+                ActiveEdges.clear();
+                for (const SweepEvent& event : Events)
+                {
+                    const int edge = event.Event >> 1;
+                    if ((event.Event & 1) == 0)
+                    {
+                        const auto position = std::lower_bound(ActiveEdges.begin(), ActiveEdges.end(), edge, isBelow);
+                        if (position != ActiveEdges.end() && testPair(edge, *position))
+                            return true;
+                        if (position != ActiveEdges.begin() && testPair(edge, *(position - 1)))
+                            return true;
+
+                        if (ActiveEdges.size() == ActiveEdges.capacity())
+                            allocations++;
+                        ActiveEdges.insert(position, edge);
+                        continue;
+                    }
+
+                    auto position = std::lower_bound(ActiveEdges.begin(), ActiveEdges.end(), edge, isBelow);
+                    if (position == ActiveEdges.end() || *position != edge)
+                        position = std::find(ActiveEdges.begin(), ActiveEdges.end(), edge);
+                    if (position != ActiveEdges.begin() && position + 1 != ActiveEdges.end() &&
+                        testPair(*(position - 1), *(position + 1)))
+                        return true;
+                    ActiveEdges.erase(position);
+                }
+                return false;
+            }
+
+            size_t ScratchBytes() const
+            {
+                return ScratchBufferBytes(Events) + ScratchBufferBytes(LeftPoints) + ScratchBufferBytes(RightPoints) +
+                    ScratchBufferBytes(NextEdges) + ScratchBufferBytes(ActiveEdges);
+            }
+        };
+
+        /// <summary>
+        /// Checks if the edge a-b intersects any edge of the index chain that does not share a point with it
+        /// </summary>
+        bool EdgeIntersectsChain(const std::vector<Vector3>& points, const int a, const int b, const std::vector<int>& chain,
+                                 const bool bClosed)
+        {
+            const int chainCount = static_cast<int>(chain.size());
+            const int edgeCount = bClosed ? chainCount : chainCount - 1;
+            for (int i = 0; i < edgeCount; i++)
+            {
+                const int c = chain[i];
+                const int d = chain[CircularIndex(i + 1, chainCount)];
+                if (c == a || c == b || d == a || d == b)
+                    continue;
+
+                if (SegmentsIntersect(points[a], points[b], points[c], points[d]))
+                    return true;
+            }
+            return false;
+        }
+
+        /// <summary>
+        /// Collects the triangles around a point ordered from its previous to its next neighbour on the outline. The chain holds
+        /// the neighbours of the point in that same order, so it starts and ends at the two outline neighbours. Both come from
+        /// the triangles themselves, so points the cleaning left out and clockwise splines need no special care. Returns false
+        /// when the triangles around the point do not form a single open fan
+        /// </summary>
+        bool GetTriangleFan(const std::vector<int>& indices, const PointTriangleAdjacency& adjacency, const int pointIndex,
+                            std::vector<int>& outTriangles, std::vector<int>& outChain)
+        {
+            //Every triangle rotated so the point comes first, all of them wind the same way so the second corner always lies
+            //on the side of the previous neighbour
+            const std::vector<int>& fanTriangles = adjacency.GetTriangles(pointIndex);
+            auto fanCorner = [&](const int triangle, const int offset)
+            {
+                const int* corners = &indices[triangle * 3];
+                const int corner = static_cast<int>(std::find(corners, corners + 3, pointIndex) - corners);
+                return corners[(corner + offset) % 3];
+            };
+
+            //The fan opens at the triangle whose start no other triangle of the fan ends at
+            int firstTriangle = -1;
+            for (const int triangle : fanTriangles)
+            {
+                const int start = fanCorner(triangle, 1);
+                const bool bContinues = std::any_of(fanTriangles.begin(), fanTriangles.end(), [&](const int other)
+                {
+                    return fanCorner(other, 2) == start;
+                });
+                if (bContinues)
+                    continue;
+                if (firstTriangle != -1)
+                    return false;
+                firstTriangle = triangle;
+            }
+            if (firstTriangle == -1)
+                return false;
+
+            outTriangles.push_back(firstTriangle);
+            outChain.push_back(fanCorner(firstTriangle, 1));
+            outChain.push_back(fanCorner(firstTriangle, 2));
+            while (outTriangles.size() < fanTriangles.size())
+            {
+                const auto next = std::find_if(fanTriangles.begin(), fanTriangles.end(), [&](const int triangle)
+                {
+                    return fanCorner(triangle, 1) == outChain.back();
+                });
+                if (next == fanTriangles.end() || std::find(outTriangles.begin(), outTriangles.end(), *next) != outTriangles.end())
+                    return false;
+
+                outTriangles.push_back(*next);
+                outChain.push_back(fanCorner(*next, 2));
+            }
+            return true;
+        }
+
+        /// <summary>
+        /// Ear clips the region ring into outRegionIndices. The new edges are the edges of the ring that did not exist before,
+        /// they get checked against the cleaned outline of the polygon and the rest of the ring so the result stays a valid
+        /// triangulation of the polygon. Nothing outside of the region is touched, so a failed check needs no undo
+        /// </summary>
+        bool TriangulateRegion(const std::vector<Vector3>& points, const std::vector<int>& outline, const std::vector<int>& ring,
+                               const std::vector<int>& newEdges, std::vector<int>& outRegionIndices)
+        {
+            for (size_t i = 0; i + 1 < newEdges.size(); i += 2)
+            {
+                const int a = newEdges[i];
+                const int b = newEdges[i + 1];
+                if (EdgeIntersectsChain(points, a, b, outline, true) || EdgeIntersectsChain(points, a, b, ring, true))
+                    return false;
+            }
+
+            outRegionIndices.clear();
+            if (ring.size() < 3)
+                return true;
+
+            std::vector<Vector3> ringPoints;
+            ringPoints.reserve(ring.size());
+            for (const int ringIndex : ring)
+            {
+                ringPoints.push_back(points[ringIndex]);
+            }
+            if (PolygonArea(ringPoints) <= 0.f)
+                return false;
+
+            TriangulatePolygon(ringPoints, outRegionIndices);
+            if (outRegionIndices.size() != (ring.size() - 2) * 3)
+                return false;
+
+            for (int& regionIndex : outRegionIndices)
+            {
+                regionIndex = ring[regionIndex];
+            }
+            return true;
+        }
+
+        /// <summary>
+        /// Writes the region triangles over the given triangle slots, removing or appending triangles when the count differs.
+        /// The slots have to be taken out of the adjacency already, every triangle that gets written or moved is added back
+        /// </summary>
+        void WriteRegion(const std::vector<int>& regionIndices, std::vector<int> triangleSlots, std::vector<int>& indices,
+                         PointTriangleAdjacency& adjacency)
+        {
+            //Slots get removed from the back so the triangles that get swapped into them are never part of the region
+            std::sort(triangleSlots.begin(), triangleSlots.end());
+            const size_t regionTriangleCount = regionIndices.size() / 3;
+            while (triangleSlots.size() > regionTriangleCount)
+            {
+                const int slot = triangleSlots.back();
+                triangleSlots.pop_back();
+
+                const int lastTriangle = static_cast<int>(indices.size()) / 3 - 1;
+                if (lastTriangle != slot)
+                {
+                    adjacency.RemoveTriangle(indices, lastTriangle);
+                    std::copy_n(indices.begin() + lastTriangle * 3, 3, indices.begin() + slot * 3);
+                    adjacency.AddTriangle(indices, slot);
+                }
+                indices.resize(lastTriangle * 3);
+            }
+            for (size_t i = 0; i < regionTriangleCount; i++)
+            {
+                int triangle = static_cast<int>(indices.size()) / 3;
+                if (i < triangleSlots.size())
+                {
+                    triangle = triangleSlots[i];
+                    std::copy_n(regionIndices.begin() + i * 3, 3, indices.begin() + triangle * 3);
+                }
+                else
+                {
+                    indices.insert(indices.end(), regionIndices.begin() + i * 3, regionIndices.begin() + i * 3 + 3);
+                }
+                adjacency.AddTriangle(indices, triangle);
+            }
+        }
+    }
+
+    /// <summary>
+    /// Buffers of one triangulator. They only ever grow, so once they fit the largest polygon seen so far triangulating does
+    /// not touch the heap anymore
+    /// </summary>
+    struct TriangulatorScratch
+    {
+        //Ring coordinates padded with the wrapped around neighbours, see ClassifyConvexBatch
+        std::vector<float> PackedX;
+        std::vector<float> PackedY;
+        std::vector<unsigned char> IsConvex;
+
+        //The remaining polygon while clipping, a doubly linked ring with the vertex type of every point
+        std::vector<int> PrevIndices;
+        std::vector<int> NextIndices;
+        std::vector<unsigned char> IsReflex;
+        std::vector<unsigned char> IsEar;
+
+        ReflexVertexGrid ReflexGrid;
+        //Components and points the reflex grid was built for while classifying, clipping them reuses the grid as it is.
+        //Clipping removes vertices from the grid, so afterwards it belongs to nothing anymore
+        const PolygonComponents* ReflexGridComponents = nullptr;
+        const std::vector<Vector3>* ReflexGridPoints = nullptr;
+        RingEdgeSweep EdgeSweep;
+        PolygonComponents Components;
+
+        //Polygons with holes: the cleaned outline and holes one after the other, then the single ring with every hole bridged
+        //in. The bridged ring visits the two ends of every bridge twice, so it gets clipped from a copy of its points
+        std::vector<int> LoopRing;
+        std::vector<int> LoopStarts;
+        //The outline followed by a single hole, to find the holes that cross the outline
+        std::vector<int> HolePairRing;
+        std::vector<int> HoleOrder;
+        std::vector<int> BridgeNodePoints;
+        std::vector<int> BridgeNodePrev;
+        std::vector<int> BridgeNodeNext;
+        std::vector<int> BridgedRing;
+        std::vector<Vector3> BridgedPoints;
+
+        //Heap allocations since the last triangulation finished
+        int Allocations = 0;
+
+        size_t ScratchBytes() const
+        {
+            return ScratchBufferBytes(PackedX) + ScratchBufferBytes(PackedY) + ScratchBufferBytes(IsConvex) +
+                ScratchBufferBytes(PrevIndices) + ScratchBufferBytes(NextIndices) + ScratchBufferBytes(IsReflex) +
+                ScratchBufferBytes(IsEar) + ReflexGrid.ScratchBytes() + EdgeSweep.ScratchBytes() +
+                ScratchBufferBytes(Components.RingIndices) + ScratchBufferBytes(Components.ReflexIndices) +
+                ScratchBufferBytes(Components.ConvexIndices) + ScratchBufferBytes(Components.EarIndices) +
+                ScratchBufferBytes(LoopRing) + ScratchBufferBytes(LoopStarts) + ScratchBufferBytes(HolePairRing) + ScratchBufferBytes(HoleOrder) +
+                ScratchBufferBytes(BridgeNodePoints) + ScratchBufferBytes(BridgeNodePrev) + ScratchBufferBytes(BridgeNodeNext) +
+                ScratchBufferBytes(BridgedRing) + ScratchBufferBytes(BridgedPoints);
+        }
+    };
+
+    namespace
+    {
+        /// <summary>
+        /// Scratch used by the free triangulation functions, one per thread so worker threads can triangulate at the same time
+        /// </summary>
+        TriangulatorScratch& GetThreadScratch()
+        {
+            thread_local TriangulatorScratch scratch;
+            return scratch;
+        }
+
+        /// <summary>
+        /// Unlinks every point that lies on the straight line through its neighbours, which includes points on top of a
+        /// neighbour and spikes that fold back onto themselves. Those add no area and would only give slivers. After a removal
+        /// the previous point gets checked again since it can line up with its new neighbour. Appends the remaining ring of the
+        /// points from begin up to end in counter clockwise order, nothing when less than 3 points remain
+        /// </summary>
+        void CleanPolygonRing(const std::vector<Vector3>& points, const int begin, const int end, std::vector<int>& outRing,
+                              TriangulatorScratch& scratch)
+        {
+            const int pointCount = end - begin;
+            int& allocations = scratch.Allocations;
+            std::vector<int>& prevIndices = scratch.PrevIndices;
+            std::vector<int>& nextIndices = scratch.NextIndices;
+
+            ResizeScratchBuffer(prevIndices, points.size(), allocations);
+            ResizeScratchBuffer(nextIndices, points.size(), allocations);
+            for (int i = begin; i < end; i++)
+            {
+                prevIndices[i] = i > begin ? i - 1 : end - 1;
+                nextIndices[i] = i + 1 < end ? i + 1 : begin;
+            }
+
+            int remainingPoints = pointCount;
+            int curPoint = begin;
+            int pointsChecked = 0;
+            while (remainingPoints >= 3 && pointsChecked < remainingPoints)
+            {
+                const int prevPoint = prevIndices[curPoint];
+                const int nextPoint = nextIndices[curPoint];
+                if (OrientationSign(points[prevPoint], points[curPoint], points[nextPoint]) != 0)
+                {
+                    curPoint = nextPoint;
+                    pointsChecked++;
+                    continue;
+                }
+
+                nextIndices[prevPoint] = nextPoint;
+                prevIndices[nextPoint] = prevPoint;
+                remainingPoints--;
+                curPoint = prevPoint;
+                pointsChecked = 0;
+            }
+
+            //Everything on one line has no area left to triangulate
+            if (remainingPoints < 3)
+                return;
+
+            const size_t ringStart = outRing.size();
+            if (ringStart + remainingPoints > outRing.capacity())
+            {
+                allocations++;
+                outRing.reserve(ringStart + remainingPoints);
+            }
+
+            //Where the removals stopped depends on the direction, the ring starts at its lowest point in x instead
+            int firstPoint = curPoint;
+            int ringPoint = curPoint;
+            double area = 0.0;
+            do
+            {
+                const Vector3& point = points[ringPoint];
+                const Vector3& nextPoint = points[nextIndices[ringPoint]];
+                area += static_cast<double>(point.X) * nextPoint.Y - static_cast<double>(nextPoint.X) * point.Y;
+                if (point.X < points[firstPoint].X || (point.X == points[firstPoint].X && point.Y < points[firstPoint].Y))
+                    firstPoint = ringPoint;
+                ringPoint = nextIndices[ringPoint];
+            }
+            while (ringPoint != curPoint);
+
+            //Splines drawn clockwise get walked backwards from the same point, so both directions give the same triangles
+            ringPoint = firstPoint;
+            do
+            {
+                outRing.push_back(ringPoint);
+                ringPoint = area < 0.0 ? prevIndices[ringPoint] : nextIndices[ringPoint];
+            }
+            while (ringPoint != firstPoint);
+        }
+
+        /// <summary>
+        /// Cleans the ring and sorts its points into convex, reflex and ear points. The crossing test can be left out by callers
+        /// that already did it on the loops the points came from
+        /// </summary>
+        void ClassifyPolygonPoints(const std::vector<Vector3>& points, PolygonComponents& outComponents,
+                                   TriangulatorScratch& scratch, const bool bCheckCrossings = true)
+        {
+            int& allocations = scratch.Allocations;
+            const std::vector<int>& ring = outComponents.RingIndices;
+
+            scratch.ReflexGridComponents = nullptr;
+            scratch.ReflexGridPoints = nullptr;
+            outComponents.RingIndices.clear();
+            CleanPolygonRing(points, 0, static_cast<int>(points.size()), outComponents.RingIndices, scratch);
+            const int ringCount = static_cast<int>(ring.size());
+            outComponents.ConvexIndices.clear();
+            outComponents.ReflexIndices.clear();
+            outComponents.EarIndices.clear();
+            outComponents.bSelfIntersecting = false;
+            if (ringCount < 3)
+                return;
+
+            //Ear clipping cannot give a valid triangulation of crossing edges, it still covers the outline but the caller
+            //gets told the triangles overlap
+            const int ringLoop[2] = {0, ringCount};
+            outComponents.bSelfIntersecting = bCheckCrossings &&
+                scratch.EdgeSweep.HasCrossingEdges(points, ring, ringLoop, 1, allocations);
+
+            //Testing if point is convex or reflex, on packed coordinates padded with the wrapped around neighbours
+            ResizeScratchBuffer(scratch.PackedX, ringCount + 2, allocations);
+            ResizeScratchBuffer(scratch.PackedY, ringCount + 2, allocations);
+            for (int i = 0; i < ringCount + 2; i++)
+            {
+                const Vector3& point = points[ring[CircularIndex(i - 1, ringCount)]];
+                scratch.PackedX[i] = point.X;
+                scratch.PackedY[i] = point.Y;
+            }
+            ResizeScratchBuffer(scratch.IsConvex, ringCount, allocations);
+            ClassifyConvexBatch(scratch.PackedX.data(), scratch.PackedY.data(), ringCount, scratch.IsConvex.data());
+
+            const int convexCount = static_cast<int>(std::count(scratch.IsConvex.begin(), scratch.IsConvex.end(), 1));
+            ClearScratchBuffer(outComponents.ConvexIndices, convexCount, allocations);
+            ClearScratchBuffer(outComponents.ReflexIndices, ringCount - convexCount, allocations);
+            ClearScratchBuffer(outComponents.EarIndices, convexCount, allocations);
+            for (int i = 0; i < ringCount; i++)
+            {
+                if (scratch.IsConvex[i])
+                    outComponents.ConvexIndices.push_back(ring[i]);
+                else
+                    outComponents.ReflexIndices.push_back(ring[i]);
+            }
+
+            //Testing if point is an ear
+            scratch.ReflexGrid.Build(points, outComponents.ReflexIndices, allocations);
+            scratch.ReflexGridComponents = &outComponents;
+            scratch.ReflexGridPoints = &points;
+
+            for (int i = 0; i < ringCount; i++)
+            {
+                if (!scratch.IsConvex[i])
+                    continue;
+
+                const int prevElement = ring[CircularIndex(i - 1, ringCount)];
+                const int nextElement = ring[CircularIndex(i + 1, ringCount)];
+                if (IsPointAnEar(prevElement, ring[i], nextElement, scratch.ReflexGrid, points))
+                    outComponents.EarIndices.push_back(ring[i]);
+            }
+        }
+
+        void ClipPolygonEars(const std::vector<Vector3>& points, const PolygonComponents& components,
+                             std::vector<int>& outIndices, TriangulationStats* outStats, TriangulatorScratch& scratch)
+        {
+            const int pointCount = static_cast<int>(points.size());
+            const std::vector<int>& ring = components.RingIndices;
+            const int ringCount = static_cast<int>(ring.size());
+            int& allocations = scratch.Allocations;
+            if (ringCount < 3)
+            {
+                if (outStats != nullptr)
+                {
+                    *outStats = TriangulationStats();
+                    outStats->VertexCount = pointCount;
+                    outStats->RemovedPoints = pointCount;
+                }
+                allocations = 0;
+                return;
+            }
+
+            std::vector<int>& prevIndices = scratch.PrevIndices;
+            std::vector<int>& nextIndices = scratch.NextIndices;
+            std::vector<unsigned char>& isReflex = scratch.IsReflex;
+            std::vector<unsigned char>& isEar = scratch.IsEar;
+            ReflexVertexGrid& reflexGrid = scratch.ReflexGrid;
+
+            //The remaining polygon is kept as a doubly linked ring over the points, clipping an ear only unlinks it
+            ResizeScratchBuffer(prevIndices, pointCount, allocations);
+            ResizeScratchBuffer(nextIndices, pointCount, allocations);
+            for (int i = 0; i < ringCount; i++)
+            {
+                prevIndices[ring[i]] = ring[CircularIndex(i - 1, ringCount)];
+                nextIndices[ring[i]] = ring[CircularIndex(i + 1, ringCount)];
+            }
+
+            AssignScratchBuffer(isReflex, pointCount, static_cast<unsigned char>(0), allocations);
+            AssignScratchBuffer(isEar, pointCount, static_cast<unsigned char>(0), allocations);
+            for (const int reflexIndex : components.ReflexIndices)
+                isReflex[reflexIndex] = 1;
+            for (const int earIndex : components.EarIndices)
+                isEar[earIndex] = 1;
+
+            //Reflex vertices can only ever turn convex, so vertices only ever leave this grid while clipping. The grid from
+            //classifying these components is still intact, it only has to be built when they were classified elsewhere
+            if (scratch.ReflexGridComponents != &components || scratch.ReflexGridPoints != &points)
+                reflexGrid.Build(points, components.ReflexIndices, allocations);
+            scratch.ReflexGridComponents = nullptr;
+            scratch.ReflexGridPoints = nullptr;
+
+            //Only the neighbours of a clipped ear can change their type, this reclassifies one of them
+            auto updateVertex = [&](const int index)
+            {
+                const int prevIndex = prevIndices[index];
+                const int nextIndex = nextIndices[index];
+                if (isReflex[index] && PointIsConvex(points[prevIndex], points[index], points[nextIndex]))
+                {
+                    isReflex[index] = 0;
+                    reflexGrid.Remove(index);
+                }
+                isEar[index] = !isReflex[index] && IsPointAnEar(prevIndex, index, nextIndex, reflexGrid, points);
+            };
+
+            const size_t indexCapacity = outIndices.capacity();
+            outIndices.reserve(outIndices.size() + (ringCount - 2) * 3);
+            if (outIndices.capacity() != indexCapacity)
+                allocations++;
+
+            int remainingPoints = ringCount;
+            int curPoint = components.EarIndices.empty() ? ring[0] : components.EarIndices[0];
+            int pointsVisited = 0;
+            int earIterations = 0;
+            while (remainingPoints > 3)
+            {
+                earIterations++;
+                //Walk the ring until we find an ear. With exact predicates a simple polygon always has one, only crossing edges
+                //can make us go around once without finding one and then the current point gets clipped anyway
+                if (!isEar[curPoint] && pointsVisited < remainingPoints)
+                {
+                    curPoint = nextIndices[curPoint];
+                    pointsVisited++;
+                    continue;
+                }
+
+                const int prevPoint = prevIndices[curPoint];
+                const int nextPoint = nextIndices[curPoint];
+
+                //Make a triangle of the ear point and its adjacent points
+                outIndices.push_back(curPoint);
+                outIndices.push_back(prevPoint);
+                outIndices.push_back(nextPoint);
+
+                //Remove the ear
+                nextIndices[prevPoint] = nextPoint;
+                prevIndices[nextPoint] = prevPoint;
+                if (isReflex[curPoint])
+                    reflexGrid.Remove(curPoint);
+                isReflex[curPoint] = 0;
+                isEar[curPoint] = 0;
+                remainingPoints--;
+
+                updateVertex(prevPoint);
+                updateVertex(nextPoint);
+
+                curPoint = nextPoint;
+                pointsVisited = 0;
+            }
+
+            outIndices.push_back(curPoint);
+            outIndices.push_back(prevIndices[curPoint]);
+            outIndices.push_back(nextIndices[curPoint]);
+
+            if (outStats != nullptr)
+            {
+                outStats->VertexCount = pointCount;
+                outStats->RemovedPoints = pointCount - ringCount;
+                outStats->ReflexCount = static_cast<int>(components.ReflexIndices.size());
+                outStats->EarIterations = earIterations;
+                outStats->TrianglesEmitted = ringCount - 2;
+                outStats->bSelfIntersecting = components.bSelfIntersecting;
+                outStats->Allocations = allocations;
+                outStats->ScratchBytes = static_cast<int>(scratch.ScratchBytes());
+            }
+            allocations = 0;
+        }
+
+        /// <summary>
+        /// Checks if the point lies inside the corner of the bridge ring at node, so a bridge from there stays inside the area
+        /// </summary>
+        bool IsLocallyInside(const std::vector<Vector3>& points, const TriangulatorScratch& scratch, const int node,
+                             const Vector3& target)
+        {
+            const Vector3& prevPoint = points[scratch.BridgeNodePoints[scratch.BridgeNodePrev[node]]];
+            const Vector3& curPoint = points[scratch.BridgeNodePoints[node]];
+            const Vector3& nextPoint = points[scratch.BridgeNodePoints[scratch.BridgeNodeNext[node]]];
+            if (OrientationSign(prevPoint, curPoint, nextPoint) >= 0)
+                return OrientationSign(prevPoint, curPoint, target) >= 0 && OrientationSign(curPoint, nextPoint, target) >= 0;
+            return OrientationSign(prevPoint, curPoint, target) >= 0 || OrientationSign(curPoint, nextPoint, target) >= 0;
+        }
+
+        /// <summary>
+        /// Finds the node of the bridge ring a hole point can be connected to (Eberly). A ray from the hole point to the right
+        /// hits the closest edge of the ring, the end of that edge furthest right is visible unless other points of the ring
+        /// lie in the triangle between the hole point, the hit and that end. Then the one of those with the smallest angle to
+        /// the ray is visible instead. Returns -1 when the hole point lies outside of the ring: the ray hits nothing, the
+        /// closest edge runs downwards or the corner it hits faces away from the hole
+        /// </summary>
+        int FindHoleBridge(const std::vector<Vector3>& points, const TriangulatorScratch& scratch, const int holeNode,
+                           const int ringNode)
+        {
+            const std::vector<int>& nodePoints = scratch.BridgeNodePoints;
+            const std::vector<int>& nextNodes = scratch.BridgeNodeNext;
+            const Vector3& holePoint = points[nodePoints[holeNode]];
+            const double holeX = holePoint.X;
+            const double holeY = holePoint.Y;
+
+            //The closest edge in either direction, edges of other holes and of the outline on the far side count too. The two
+            //edges of a bridge lie on top of each other, the one running upwards is the side facing the hole
+            double hitX = std::numeric_limits<double>::infinity();
+            int hitNode = -1;
+            int node = ringNode;
+            do
+            {
+                const Vector3& a = points[nodePoints[node]];
+                const Vector3& b = points[nodePoints[nextNodes[node]]];
+                if (a.Y != b.Y && holeY >= std::min(a.Y, b.Y) && holeY <= std::max(a.Y, b.Y))
+                {
+                    //Measured from the lower end, so both edges of a bridge give exactly the same hit
+                    const Vector3& low = a.Y < b.Y ? a : b;
+                    const Vector3& high = a.Y < b.Y ? b : a;
+                    const double x = low.X + (holeY - low.Y) * (static_cast<double>(high.X) - low.X) /
+                        (static_cast<double>(high.Y) - low.Y);
+                    if (x >= holeX && (x < hitX || (x == hitX && a.Y < b.Y)))
+                    {
+                        hitX = x;
+                        hitNode = node;
+                    }
+                }
+                node = nextNodes[node];
+            }
+            while (node != ringNode);
+
+            if (hitNode == -1)
+                return -1;
+
+            //A ray through a corner of the ring is inside when the corner opens towards the hole, it is visible then
+            const Vector3& hitStart = points[nodePoints[hitNode]];
+            const Vector3& hitEnd = points[nodePoints[nextNodes[hitNode]]];
+            if (holeY == hitStart.Y || holeY == hitEnd.Y)
+            {
+                const int cornerNode = holeY == hitStart.Y ? hitNode : nextNodes[hitNode];
+                if (hitX == holeX)
+                {
+                    //The hole touches the ring in this point
+                    return cornerNode;
+                }
+                return IsLocallyInside(points, scratch, cornerNode, holePoint) ? cornerNode : -1;
+            }
+
+            //Seen from inside, the ring runs upwards on the right of the hole
+            if (hitStart.Y > hitEnd.Y)
+                return -1;
+            int bridgeNode = hitStart.X > hitEnd.X ? hitNode : nextNodes[hitNode];
+
+            const Vector3 hitPoint = {static_cast<float>(hitX), holePoint.Y, holePoint.Z};
+            const Vector3 candidatePoint = points[nodePoints[bridgeNode]];
+            double bestTangent = std::numeric_limits<double>::infinity();
+            double bestX = candidatePoint.X;
+            const int stopNode = bridgeNode;
+            node = bridgeNode;
+            do
+            {
+                const Vector3& point = points[nodePoints[node]];
+                if (holeX < point.X && point.X <= candidatePoint.X &&
+                    IsPointInTriangle(holePoint, hitPoint, candidatePoint, point))
+                {
+                    const double tangent = std::abs(holeY - point.Y) / (point.X - holeX);
+                    if ((tangent < bestTangent || (tangent == bestTangent && point.X < bestX)) &&
+                        IsLocallyInside(points, scratch, node, holePoint))
+                    {
+                        bridgeNode = node;
+                        bestTangent = tangent;
+                        bestX = point.X;
+                    }
+                }
+                node = nextNodes[node];
+            }
+            while (node != stopNode);
+            return bridgeNode;
+        }
+
+        /// <summary>
+        /// Connects every hole in LoopRing to the outline with a bridge, a pair of edges there and back, and writes the single
+        /// ring that walks around the outline and into every hole to BridgedRing. Holes get bridged from right to left so a
+        /// bridge can also end on a hole that is already part of the ring
+        /// </summary>
+        void BridgeHoles(const std::vector<Vector3>& points, TriangulatorScratch& scratch)
+        {
+            int& allocations = scratch.Allocations;
+            const std::vector<int>& loopRing = scratch.LoopRing;
+            const std::vector<int>& loopStarts = scratch.LoopStarts;
+            const int loopCount = static_cast<int>(loopStarts.size()) - 1;
+            const int loopPointCount = static_cast<int>(loopRing.size());
+
+            //Every bridge adds a second node for both of its ends
+            std::vector<int>& nodePoints = scratch.BridgeNodePoints;
+            std::vector<int>& prevNodes = scratch.BridgeNodePrev;
+            std::vector<int>& nextNodes = scratch.BridgeNodeNext;
+            const int nodeCapacity = loopPointCount + (loopCount - 1) * 2;
+            ResizeScratchBuffer(nodePoints, nodeCapacity, allocations);
+            ResizeScratchBuffer(prevNodes, nodeCapacity, allocations);
+            ResizeScratchBuffer(nextNodes, nodeCapacity, allocations);
+            for (int loop = 0; loop < loopCount; loop++)
+            {
+                const int begin = loopStarts[loop];
+                const int end = loopStarts[loop + 1];
+                for (int node = begin; node < end; node++)
+                {
+                    nodePoints[node] = loopRing[node];
+                    prevNodes[node] = node > begin ? node - 1 : end - 1;
+                    nextNodes[node] = node + 1 < end ? node + 1 : begin;
+                }
+            }
+
+            //The point of every hole furthest right, holes go from right to left
+            std::vector<int>& holeOrder = scratch.HoleOrder;
+            ResizeScratchBuffer(holeOrder, loopCount - 1, allocations);
+            for (int loop = 1; loop < loopCount; loop++)
+            {
+                int rightNode = loopStarts[loop];
+                for (int node = loopStarts[loop] + 1; node < loopStarts[loop + 1]; node++)
+                {
+                    const Vector3& point = points[nodePoints[node]];
+                    const Vector3& rightPoint = points[nodePoints[rightNode]];
+                    if (point.X > rightPoint.X || (point.X == rightPoint.X && point.Y < rightPoint.Y))
+                        rightNode = node;
+                }
+                holeOrder[loop - 1] = rightNode;
+            }
+            std::sort(holeOrder.begin(), holeOrder.end(), [&points, &nodePoints](const int a, const int b)
+            {
+                return points[nodePoints[a]].X > points[nodePoints[b]].X;
+            });
+
+            int nodeCount = loopPointCount;
+            for (const int holeNode : holeOrder)
+            {
+                const int bridgeNode = FindHoleBridge(points, scratch, holeNode, 0);
+                if (bridgeNode == -1)
+                    continue;
+
+                //bridge -> hole -> around the hole -> hole copy -> bridge copy -> rest of the ring
+                const int bridgeCopy = nodeCount++;
+                const int holeCopy = nodeCount++;
+                nodePoints[bridgeCopy] = nodePoints[bridgeNode];
+                nodePoints[holeCopy] = nodePoints[holeNode];
+                const int afterBridge = nextNodes[bridgeNode];
+                const int beforeHole = prevNodes[holeNode];
+
+                nextNodes[bridgeNode] = holeNode;
+                prevNodes[holeNode] = bridgeNode;
+                nextNodes[beforeHole] = holeCopy;
+                prevNodes[holeCopy] = beforeHole;
+                nextNodes[holeCopy] = bridgeCopy;
+                prevNodes[bridgeCopy] = holeCopy;
+                nextNodes[bridgeCopy] = afterBridge;
+                prevNodes[afterBridge] = bridgeCopy;
+            }
+
+            std::vector<int>& bridgedRing = scratch.BridgedRing;
+            ClearScratchBuffer(bridgedRing, nodeCount, allocations);
+            int node = 0;
+            do
+            {
+                bridgedRing.push_back(nodePoints[node]);
+                node = nextNodes[node];
+            }
+            while (node != 0);
+        }
+
+        /// <summary>
+        /// Leaves every hole that crosses or touches the outline out of LoopRing. Such a hole has no clear inside, without it
+        /// the area still covers the outline. Each hole gets swept together with the outline, so callers only do this once
+        /// the sweep over all loops found a crossing
+        /// </summary>
+        void DropCrossingHoles(const std::vector<Vector3>& points, TriangulatorScratch& scratch)
+        {
+            int& allocations = scratch.Allocations;
+            std::vector<int>& loopRing = scratch.LoopRing;
+            std::vector<int>& loopStarts = scratch.LoopStarts;
+            std::vector<int>& pairRing = scratch.HolePairRing;
+            const int loopCount = static_cast<int>(loopStarts.size()) - 1;
+            const int outlineCount = loopStarts[1];
+
+            //Kept holes move down over the dropped ones, they never move past their own start
+            int keptLoopCount = 1;
+            int keptEnd = outlineCount;
+            for (int loop = 1; loop < loopCount; loop++)
+            {
+                const int begin = loopStarts[loop];
+                const int end = loopStarts[loop + 1];
+                ClearScratchBuffer(pairRing, end - begin + outlineCount, allocations);
+                pairRing.insert(pairRing.end(), loopRing.begin(), loopRing.begin() + outlineCount);
+                pairRing.insert(pairRing.end(), loopRing.begin() + begin, loopRing.begin() + end);
+                const int pairStarts[3] = {0, outlineCount, static_cast<int>(pairRing.size())};
+                if (scratch.EdgeSweep.HasCrossingEdges(points, pairRing, pairStarts, 2, allocations))
+                    continue;
+
+                std::copy(loopRing.begin() + begin, loopRing.begin() + end, loopRing.begin() + keptEnd);
+                loopStarts[keptLoopCount++] = keptEnd;
+                keptEnd += end - begin;
+            }
+            loopRing.resize(keptEnd);
+            loopStarts[keptLoopCount] = keptEnd;
+            loopStarts.resize(keptLoopCount + 1);
+        }
+
+        void TriangulatePolygonHoles(const std::vector<Vector3>& points, const std::vector<int>& holeStarts,
+                                     std::vector<int>& outIndices, TriangulationStats* outStats, TriangulatorScratch& scratch)
+        {
+            const int pointCount = static_cast<int>(points.size());
+            const int holeCount = static_cast<int>(holeStarts.size());
+            int& allocations = scratch.Allocations;
+            std::vector<int>& loopRing = scratch.LoopRing;
+            std::vector<int>& loopStarts = scratch.LoopStarts;
+
+            //Clean every loop on its own, the outline winds counter clockwise and the holes clockwise
+            ClearScratchBuffer(loopRing, pointCount, allocations);
+            ClearScratchBuffer(loopStarts, holeCount + 2, allocations);
+            for (int loop = 0; loop <= holeCount; loop++)
+            {
+                const int begin = loop > 0 ? holeStarts[loop - 1] : 0;
+                const int end = loop < holeCount ? holeStarts[loop] : pointCount;
+                const int loopStart = static_cast<int>(loopRing.size());
+                if (begin < end)
+                    CleanPolygonRing(points, begin, end, loopRing, scratch);
+                if (static_cast<int>(loopRing.size()) == loopStart)
+                {
+                    //Without an outline the holes have nothing to cut out of
+                    if (loop == 0)
+                        break;
+                    continue;
+                }
+
+                if (loop > 0)
+                    std::reverse(loopRing.begin() + loopStart, loopRing.end());
+                loopStarts.push_back(loopStart);
+            }
+
+            if (loopStarts.empty())
+            {
+                if (outStats != nullptr)
+                {
+                    *outStats = TriangulationStats();
+                    outStats->VertexCount = pointCount;
+                    outStats->RemovedPoints = pointCount;
+                }
+                allocations = 0;
+                return;
+            }
+            loopStarts.push_back(static_cast<int>(loopRing.size()));
+
+            //The bridges overlap themselves on purpose, so crossings are looked for on the loops before bridging
+            const bool bSelfIntersecting = scratch.EdgeSweep.HasCrossingEdges(
+                points, loopRing, loopStarts.data(), static_cast<int>(loopStarts.size()) - 1, allocations);
+            if (bSelfIntersecting)
+                DropCrossingHoles(points, scratch);
+            BridgeHoles(points, scratch);
+
+            const std::vector<int>& bridgedRing = scratch.BridgedRing;
+            std::vector<Vector3>& bridgedPoints = scratch.BridgedPoints;
+            ResizeScratchBuffer(bridgedPoints, bridgedRing.size(), allocations);
+            for (size_t i = 0; i < bridgedRing.size(); i++)
+            {
+                bridgedPoints[i] = points[bridgedRing[i]];
+            }
+
+            PolygonComponents& components = scratch.Components;
+            ClassifyPolygonPoints(bridgedPoints, components, scratch, false);
+            components.bSelfIntersecting = bSelfIntersecting;
+
+            const size_t firstIndex = outIndices.size();
+            ClipPolygonEars(bridgedPoints, components, outIndices, outStats, scratch);
+            for (size_t i = firstIndex; i < outIndices.size(); i++)
+            {
+                outIndices[i] = bridgedRing[outIndices[i]];
+            }
+
+            if (outStats != nullptr)
+            {
+                const int bridgedRemoved = static_cast<int>(bridgedRing.size() - components.RingIndices.size());
+                outStats->VertexCount = pointCount;
+                outStats->RemovedPoints = pointCount - static_cast<int>(loopRing.size()) + bridgedRemoved;
+                outStats->bSelfIntersecting = bSelfIntersecting;
+            }
+        }
+
+        /// <summary>
+        /// Cleans the edited polygon like a full triangulation would and checks that every point of the cleaned outline besides
+        /// the edited one is a corner of the triangulation. The adjacency can still use the numbering from before the edit:
+        /// indexShift is added to every point from editedIndex on (+1 after a removal) or after it (-1 after an insert).
+        /// Together with the triangle count the caller checks, that makes the triangulation use the same points as the outline
+        /// </summary>
+        bool CleanEditedOutline(const std::vector<Vector3>& points, const PointTriangleAdjacency& adjacency, const int editedIndex,
+                                const int indexShift, std::vector<int>& outOutline)
+        {
+            outOutline.clear();
+            CleanPolygonRing(points, 0, static_cast<int>(points.size()), outOutline, GetThreadScratch());
+            if (outOutline.size() < 3)
+                return false;
+
+            for (const int outlineIndex : outOutline)
+            {
+                if (outlineIndex == editedIndex && indexShift <= 0)
+                    continue;
+
+                const bool bShifted = indexShift > 0 ? outlineIndex >= editedIndex : outlineIndex > editedIndex;
+                if (adjacency.GetTriangles(bShifted ? outlineIndex + indexShift : outlineIndex).empty())
+                    return false;
+            }
+            return true;
+        }
+    }
+
+#if defined(_MSC_VER)
+    //The exact sum relies on the rounding error of every addition, fast floating point math would reassociate it away
+#pragma float_control(precise, on, push)
+#endif
+
+    namespace
+    {
+        /// <summary>
+        /// Adds two doubles without losing anything, a + b is exactly outSum + outError
+        /// </summary>
+        inline void TwoSum(const double a, const double b, double& outSum, double& outError)
+        {
+            outSum = a + b;
+            const double bVirtual = outSum - a;
+            const double aVirtual = outSum - bVirtual;
+            outError = (a - aVirtual) + (b - bVirtual);
+        }
+
+        /// <summary>
+        /// Exact sign of the orientation. A product of two floats always fits a double, so the determinant is written as a sum of
+        /// six exact products and only that sum needs care. It is accumulated as a non-overlapping expansion (Shewchuk), whose
+        /// sign is the sign of its largest non zero component
+        /// </summary>
+        int OrientationSignExact(const Vector3& a, const Vector3& b, const Vector3& c)
+        {
+            const double terms[6] = {
+                static_cast<double>(b.X) * c.Y, -static_cast<double>(b.X) * a.Y, -static_cast<double>(a.X) * c.Y,
+                -static_cast<double>(c.X) * b.Y, static_cast<double>(c.X) * a.Y, static_cast<double>(a.X) * b.Y
+            };
+
+            double expansion[6];
+            int expansionCount = 0;
+            for (const double term : terms)
+            {
+                double sum = term;
+                for (int i = 0; i < expansionCount; i++)
+                {
+                    TwoSum(sum, expansion[i], sum, expansion[i]);
+                }
+                expansion[expansionCount++] = sum;
+            }
+
+            for (int i = expansionCount - 1; i >= 0; i--)
+            {
+                if (expansion[i] > 0.0)
+                    return 1;
+                if (expansion[i] < 0.0)
+                    return -1;
+            }
+            return 0;
+        }
+    }
+
+    int OrientationSign(const Vector3& a, const Vector3& b, const Vector3& c)
+    {
+        const double detLeft = (static_cast<double>(b.X) - a.X) * (static_cast<double>(c.Y) - a.Y);
+        const double detRight = (static_cast<double>(c.X) - a.X) * (static_cast<double>(b.Y) - a.Y);
+        const double det = detLeft - detRight;
+
+        //Largest error the double evaluation can have (Shewchuk's ccwerrboundA), only results inside of it need the exact sum
+        const double errorBound = 3.3306690738754716e-16 * (std::abs(detLeft) + std::abs(detRight));
+        if (det > errorBound)
+            return 1;
+        if (det < -errorBound)
+            return -1;
+        return OrientationSignExact(a, b, c);
+    }
+
+#if defined(_MSC_VER)
+#pragma float_control(pop)
+#endif
+
+    bool PointIsConvex(const Vector3& prevPoint, const Vector3& curPoint, const Vector3& nextPoint)
+    {
+        return OrientationSign(prevPoint, curPoint, nextPoint) > 0;
+    }
+
+    bool IsPointInTriangle(const Vector3& t1, const Vector3& t2, const Vector3& t3, const Vector3& p)
+    {
+        //Inside when the point lies on the same side of all three edges
+        const int d1 = OrientationSign(t1, t2, p);
+        const int d2 = OrientationSign(t2, t3, p);
+        const int d3 = OrientationSign(t3, t1, p);
+        const bool bHasNegative = d1 < 0 || d2 < 0 || d3 < 0;
+        const bool bHasPositive = d1 > 0 || d2 > 0 || d3 > 0;
+        return !(bHasNegative && bHasPositive);
+    }
+
+    float PolygonArea(const std::vector<Vector3>& points)
+    {
+        double area = 0.0;
+        const int pointCount = static_cast<int>(points.size());
+        for (int i = 0; i < pointCount; i++)
+        {
+            const Vector3& curPoint = points[i];
+            const Vector3& nextPoint = points[CircularIndex(i + 1, pointCount)];
+            area += static_cast<double>(curPoint.X) * nextPoint.Y - static_cast<double>(nextPoint.X) * curPoint.Y;
+        }
+        return static_cast<float>(area * 0.5);
+    }
+
+    float TriangleArea(const Vector3& t1, const Vector3& t2, const Vector3& t3)
+    {
+        return 0.5f * ((t2.X - t1.X) * (t3.Y - t1.Y) - (t3.X - t1.X) * (t2.Y - t1.Y));
+    }
+
+    void GetPolygonComponents(const std::vector<Vector3>& points, PolygonComponents& outComponents)
+    {
+        ClassifyPolygonPoints(points, outComponents, GetThreadScratch());
+    }
+
+    void TrianglesFromPoints(const std::vector<Vector3>& points, const PolygonComponents& components,
+                             std::vector<int>& outIndices, TriangulationStats* outStats)
+    {
+        ClipPolygonEars(points, components, outIndices, outStats, GetThreadScratch());
+    }
+
+    void TriangulatePolygonWithHoles(const std::vector<Vector3>& points, const std::vector<int>& holeStarts,
+                                     std::vector<int>& outIndices, TriangulationStats* outStats)
+    {
+        if (holeStarts.empty())
+            TriangulatePolygon(points, outIndices, outStats);
+        else
+            TriangulatePolygonHoles(points, holeStarts, outIndices, outStats, GetThreadScratch());
+    }
+
+    void TrianglesToIndices(const std::vector<Triangle>& triangles, std::vector<Vector3>& vertices,
+                            std::vector<int>& indices)
+    {
+        std::unordered_map<Vector3, int, VertexHash, VertexEqual> vertexLookup;
+        vertexLookup.reserve(vertices.size() + triangles.size() * 3);
+        for (int i = 0; i < static_cast<int>(vertices.size()); i++)
+        {
+            vertexLookup.emplace(vertices[i], i);
+        }
+
+        auto addUnique = [&](const Vector3& point)
+        {
+            const auto result = vertexLookup.emplace(point, static_cast<int>(vertices.size()));
+            if (result.second)
+                vertices.push_back(point);
+            return result.first->second;
+        };
+
+        indices.reserve(indices.size() + triangles.size() * 3);
+        for (const Triangle& triangle : triangles)
+        {
+            indices.push_back(addUnique(triangle.Point1));
+            indices.push_back(addUnique(triangle.Point2));
+            indices.push_back(addUnique(triangle.Point3));
+        }
+    }
+
+    void TriangulatePolygon(const std::vector<Vector3>& points, std::vector<int>& outIndices, TriangulationStats* outStats)
+    {
+        TriangulatorScratch& scratch = GetThreadScratch();
+        ClassifyPolygonPoints(points, scratch.Components, scratch);
+        ClipPolygonEars(points, scratch.Components, outIndices, outStats, scratch);
+    }
+
+    Triangulator::Triangulator()
+        : Scratch(new TriangulatorScratch())
+    {
+    }
+
+    Triangulator::~Triangulator() = default;
+
+    const PolygonComponents& Triangulator::ClassifyPoints(const std::vector<Vector3>& points)
+    {
+        ClassifyPolygonPoints(points, Scratch->Components, *Scratch);
+        return Scratch->Components;
+    }
+
+    void Triangulator::ClipEars(const std::vector<Vector3>& points, std::vector<int>& outIndices, TriangulationStats* outStats)
+    {
+        ClipPolygonEars(points, Scratch->Components, outIndices, outStats, *Scratch);
+    }
+
+    void Triangulator::Triangulate(const std::vector<Vector3>& points, std::vector<int>& outIndices, TriangulationStats* outStats)
+    {
+        ClassifyPoints(points);
+        ClipEars(points, outIndices, outStats);
+    }
+
+    void Triangulator::TriangulateWithHoles(const std::vector<Vector3>& points, const std::vector<int>& holeStarts,
+                                            std::vector<int>& outIndices, TriangulationStats* outStats)
+    {
+        if (holeStarts.empty())
+            Triangulate(points, outIndices, outStats);
+        else
+            TriangulatePolygonHoles(points, holeStarts, outIndices, outStats, *Scratch);
+    }
+
+    void PointTriangleAdjacency::Build(const int pointCount, const std::vector<int>& indices)
+    {
+        PointTriangles.assign(pointCount, std::vector<int>());
+        const int triangleCount = static_cast<int>(indices.size()) / 3;
+        for (int triangle = 0; triangle < triangleCount; triangle++)
+        {
+            AddTriangle(indices, triangle);
+        }
+    }
+
+    void PointTriangleAdjacency::Reset()
+    {
+        PointTriangles.clear();
+        PointTriangles.shrink_to_fit();
+    }
+
+    int PointTriangleAdjacency::GetPointCount() const
+    {
+        return static_cast<int>(PointTriangles.size());
+    }
+
+    const std::vector<int>& PointTriangleAdjacency::GetTriangles(const int pointIndex) const
+    {
+        return PointTriangles[pointIndex];
+    }
+
+    void PointTriangleAdjacency::AddTriangle(const std::vector<int>& indices, const int triangle)
+    {
+        for (int corner = 0; corner < 3; corner++)
+        {
+            PointTriangles[indices[triangle * 3 + corner]].push_back(triangle);
+        }
+    }
+
+    void PointTriangleAdjacency::RemoveTriangle(const std::vector<int>& indices, const int triangle)
+    {
+        for (int corner = 0; corner < 3; corner++)
+        {
+            std::vector<int>& triangles = PointTriangles[indices[triangle * 3 + corner]];
+            const auto position = std::find(triangles.begin(), triangles.end(), triangle);
+            if (position == triangles.end())
+                continue;
+
+            *position = triangles.back();
+            triangles.pop_back();
+        }
+    }
+
+    void PointTriangleAdjacency::InsertPoint(const int pointIndex)
+    {
+        PointTriangles.emplace(PointTriangles.begin() + pointIndex);
+    }
+
+    void PointTriangleAdjacency::RemovePoint(const int pointIndex)
+    {
+        PointTriangles.erase(PointTriangles.begin() + pointIndex);
+    }
+
+    bool RetriangulateMovedPoint(const std::vector<Vector3>& points, const int pointIndex, std::vector<int>& indices,
+                                 PointTriangleAdjacency& adjacency)
+    {
+        const int pointCount = static_cast<int>(points.size());
+        std::vector<int> outline;
+        if (pointCount < 3 || adjacency.GetPointCount() != pointCount ||
+            !CleanEditedOutline(points, adjacency, pointIndex, 0, outline))
+            return false;
+
+        const int outlineCount = static_cast<int>(outline.size());
+        const int outlinePosition = static_cast<int>(std::find(outline.begin(), outline.end(), pointIndex) - outline.begin());
+        if (outlinePosition == outlineCount)
+        {
+            //The point got moved along a straight edge and is still left out, there is nothing to triangulate again
+            return adjacency.GetTriangles(pointIndex).empty() && indices.size() == static_cast<size_t>(outlineCount - 2) * 3;
+        }
+        if (indices.size() != static_cast<size_t>(outlineCount - 2) * 3)
+            return false;
+
+        std::vector<int> fanTriangles;
+        std::vector<int> chain;
+        if (!GetTriangleFan(indices, adjacency, pointIndex, fanTriangles, chain))
+            return false;
+
+        //The fan has to open towards the neighbours the point has on the outline now, else the winding or the left out
+        //points around it changed
+        const int prevIndex = outline[CircularIndex(outlinePosition - 1, outlineCount)];
+        const int nextIndex = outline[CircularIndex(outlinePosition + 1, outlineCount)];
+        if (chain.front() != prevIndex || chain.back() != nextIndex)
+            return false;
+
+        //The region is the moved point plus its neighbours, walked in outline order
+        std::vector<int> ring;
+        ring.push_back(prevIndex);
+        ring.push_back(pointIndex);
+        ring.insert(ring.end(), chain.rbegin(), chain.rend() - 1);
+
+        std::vector<int> regionIndices;
+        if (!TriangulateRegion(points, outline, ring, {prevIndex, pointIndex, pointIndex, nextIndex}, regionIndices))
+            return false;
+
+        for (const int fanTriangle : fanTriangles)
+        {
+            adjacency.RemoveTriangle(indices, fanTriangle);
+        }
+        WriteRegion(regionIndices, fanTriangles, indices, adjacency);
+        return true;
+    }
+
+    bool RetriangulateInsertedPoint(const std::vector<Vector3>& points, const int pointIndex, std::vector<int>& indices,
+                                    PointTriangleAdjacency& adjacency)
+    {
+        const int pointCount = static_cast<int>(points.size());
+        std::vector<int> outline;
+        if (pointCount < 4 || adjacency.GetPointCount() != pointCount - 1 ||
+            !CleanEditedOutline(points, adjacency, pointIndex, -1, outline))
+            return false;
+
+        auto renumber = [&indices, pointIndex]()
+        {
+            for (int& index : indices)
+            {
+                if (index >= pointIndex)
+                    index++;
+            }
+        };
+
+        const int outlineCount = static_cast<int>(outline.size());
+        const int outlinePosition = static_cast<int>(std::find(outline.begin(), outline.end(), pointIndex) - outline.begin());
+        if (outlinePosition == outlineCount)
+        {
+            //Inserted on a straight edge, the point gets left out like every other collinear point
+            if (indices.size() != static_cast<size_t>(outlineCount - 2) * 3)
+                return false;
+
+            adjacency.InsertPoint(pointIndex);
+            renumber();
+            return true;
+        }
+        if (indices.size() != static_cast<size_t>(outlineCount - 3) * 3)
+            return false;
+
+        //The new point splits the outline edge between its neighbours, only the triangle on that edge changes. The edge
+        //belongs to a single triangle, looked up with the numbering from before the insert
+        const int prevIndex = outline[CircularIndex(outlinePosition - 1, outlineCount)];
+        const int nextIndex = outline[CircularIndex(outlinePosition + 1, outlineCount)];
+        const int oldPrevIndex = prevIndex > pointIndex ? prevIndex - 1 : prevIndex;
+        const int oldNextIndex = nextIndex > pointIndex ? nextIndex - 1 : nextIndex;
+        int edgeTriangle = -1;
+        int oppositeIndex = -1;
+        for (const int triangle : adjacency.GetTriangles(oldPrevIndex))
+        {
+            const int* corners = &indices[triangle * 3];
+            const int nextCorner = static_cast<int>(std::find(corners, corners + 3, oldNextIndex) - corners);
+            if (nextCorner == 3)
+                continue;
+            if (edgeTriangle != -1)
+                return false;
+
+            const int prevCorner = static_cast<int>(std::find(corners, corners + 3, oldPrevIndex) - corners);
+            edgeTriangle = triangle;
+            oppositeIndex = corners[3 - prevCorner - nextCorner];
+        }
+        if (edgeTriangle == -1)
+            return false;
+
+        if (oppositeIndex >= pointIndex)
+            oppositeIndex++;
+        const std::vector<int> ring = {prevIndex, pointIndex, nextIndex, oppositeIndex};
+        std::vector<int> regionIndices;
+        if (!TriangulateRegion(points, outline, ring, {prevIndex, pointIndex, pointIndex, nextIndex}, regionIndices))
+            return false;
+
+        adjacency.RemoveTriangle(indices, edgeTriangle);
+        adjacency.InsertPoint(pointIndex);
+        renumber();
+        WriteRegion(regionIndices, {edgeTriangle}, indices, adjacency);
+        return true;
+    }
+
+    bool RetriangulateRemovedPoint(const std::vector<Vector3>& points, const int pointIndex, std::vector<int>& indices,
+                                   PointTriangleAdjacency& adjacency)
+    {
+        const int pointCount = static_cast<int>(points.size());
+        std::vector<int> outline;
+        if (pointCount < 3 || adjacency.GetPointCount() != pointCount + 1 ||
+            !CleanEditedOutline(points, adjacency, pointIndex, 1, outline))
+            return false;
+
+        auto renumber = [&indices, pointIndex]()
+        {
+            for (int& index : indices)
+            {
+                if (index > pointIndex)
+                    index--;
+            }
+        };
+
+        const int outlineCount = static_cast<int>(outline.size());
+        if (adjacency.GetTriangles(pointIndex).empty())
+        {
+            //The point was left out of the triangulation already, only the numbering changes
+            if (indices.size() != static_cast<size_t>(outlineCount - 2) * 3)
+                return false;
+
+            adjacency.RemovePoint(pointIndex);
+            renumber();
+            return true;
+        }
+        if (indices.size() != static_cast<size_t>(outlineCount - 1) * 3)
+            return false;
+
+        //The fan is looked up with the numbering from before the removal
+        std::vector<int> fanTriangles;
+        std::vector<int> chain;
+        if (!GetTriangleFan(indices, adjacency, pointIndex, fanTriangles, chain))
+            return false;
+        for (int& chainIndex : chain)
+        {
+            if (chainIndex > pointIndex)
+                chainIndex--;
+        }
+
+        //Without the point its neighbours get connected directly, they have to follow each other on the outline now
+        const int prevPosition = static_cast<int>(std::find(outline.begin(), outline.end(), chain.front()) - outline.begin());
+        if (prevPosition == outlineCount || outline[CircularIndex(prevPosition + 1, outlineCount)] != chain.back())
+            return false;
+
+        //Closing the ring with the rest of the fan
+        const std::vector<int> ring(chain.rbegin(), chain.rend());
+        std::vector<int> regionIndices;
+        if (!TriangulateRegion(points, outline, ring, {ring.back(), ring.front()}, regionIndices))
+            return false;
+
+        for (const int fanTriangle : fanTriangles)
+        {
+            adjacency.RemoveTriangle(indices, fanTriangle);
+        }
+        adjacency.RemovePoint(pointIndex);
+        renumber();
+        WriteRegion(regionIndices, fanTriangles, indices, adjacency);
+        return true;
+    }
+
+    void SimplifyPolygon(const std::vector<Vector3>& points, const float maxError, std::vector<int>& outKeptIndices)
+    {
+        outKeptIndices.clear();
+        const int pointCount = static_cast<int>(points.size());
+
+        //The ring gets split into two chains at the point farthest from the first one, both ends of a chain are always kept
+        int farthestIndex = 0;
+        float farthestDistanceSquared = -1.f;
+        for (int i = 1; i < pointCount; i++)
+        {
+            const float dx = points[i].X - points[0].X;
+            const float dy = points[i].Y - points[0].Y;
+            const float dz = points[i].Z - points[0].Z;
+            const float distanceSquared = dx * dx + dy * dy + dz * dz;
+            if (distanceSquared > farthestDistanceSquared)
+            {
+                farthestDistanceSquared = distanceSquared;
+                farthestIndex = i;
+            }
+        }
+
+        std::vector<unsigned char> isKept(pointCount, 0);
+        if (pointCount > 0)
+        {
+            isKept[0] = 1;
+            isKept[farthestIndex] = 1;
+        }
+
+        //Chains are ranges of ring positions, the second chain wraps around past the last point
+        const float maxErrorSquared = maxError * maxError;
+        std::vector<std::pair<int, int>> chains;
+        chains.emplace_back(0, farthestIndex);
+        chains.emplace_back(farthestIndex, pointCount);
+        while (pointCount > 3 && !chains.empty())
+        {
+            const std::pair<int, int> chain = chains.back();
+            chains.pop_back();
+            if (chain.second - chain.first < 2)
+                continue;
+
+            const Vector3& start = points[chain.first];
+            const Vector3& end = points[CircularIndex(chain.second, pointCount)];
+
+            int splitIndex = -1;
+            float splitDistanceSquared = maxErrorSquared;
+            for (int i = chain.first + 1; i < chain.second; i++)
+            {
+                const float distanceSquared = SegmentDistanceSquared(points[i], start, end);
+                if (distanceSquared > splitDistanceSquared)
+                {
+                    splitDistanceSquared = distanceSquared;
+                    splitIndex = i;
+                }
+            }
+
+            if (splitIndex == -1)
+                continue;
+
+            isKept[splitIndex] = 1;
+            chains.emplace_back(chain.first, splitIndex);
+            chains.emplace_back(splitIndex, chain.second);
+        }
+
+        //With a large error both chains collapse onto the line between the anchors, the farthest point keeps it a polygon
+        int keptCount = 0;
+        int thirdIndex = -1;
+        float thirdDistanceSquared = -1.f;
+        for (int i = 0; i < pointCount; i++)
+        {
+            if (isKept[i])
+            {
+                keptCount++;
+                continue;
+            }
+            const float distanceSquared = SegmentDistanceSquared(points[i], points[0], points[farthestIndex]);
+            if (distanceSquared > thirdDistanceSquared)
+            {
+                thirdDistanceSquared = distanceSquared;
+                thirdIndex = i;
+            }
+        }
+        if (keptCount < 3 && thirdIndex != -1)
+            isKept[thirdIndex] = 1;
+
+        for (int i = 0; i < pointCount; i++)
+        {
+            if (isKept[i] || pointCount <= 3)
+                outKeptIndices.push_back(i);
+        }
+    }
+
+    void ConvexPartition(const std::vector<Vector3>& points, const std::vector<int>& indices, const int maxPieceVertices,
+                         std::vector<std::vector<int>>& outPieces)
+    {
+        outPieces.clear();
+        const int triangleCount = static_cast<int>(indices.size()) / 3;
+
+        //Every triangle starts as its own piece, triangles are emitted clockwise so they get flipped here
+        std::vector<std::vector<int>> pieces(triangleCount);
+        std::vector<int> pieceParents(triangleCount);
+        std::unordered_map<uint64_t, int> edgeTriangles;
+        std::vector<std::pair<int, int>> diagonals;
+        for (int triangle = 0; triangle < triangleCount; triangle++)
+        {
+            pieces[triangle] = {indices[triangle * 3 + 1], indices[triangle * 3], indices[triangle * 3 + 2]};
+            pieceParents[triangle] = triangle;
+
+            for (int corner = 0; corner < 3; corner++)
+            {
+                const uint32_t a = static_cast<uint32_t>(pieces[triangle][corner]);
+                const uint32_t b = static_cast<uint32_t>(pieces[triangle][(corner + 1) % 3]);
+                const uint64_t edgeKey = (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+                const auto inserted = edgeTriangles.emplace(edgeKey, triangle);
+                if (!inserted.second)
+                    diagonals.emplace_back(inserted.first->second, triangle);
+            }
+        }
+
+        const auto findPiece = [&pieceParents](int triangle)
+        {
+            while (pieceParents[triangle] != triangle)
+            {
+                pieceParents[triangle] = pieceParents[pieceParents[triangle]];
+                triangle = pieceParents[triangle];
+            }
+            return triangle;
+        };
+
+        std::vector<int> merged;
+        for (const std::pair<int, int>& diagonal : diagonals)
+        {
+            const int firstPiece = findPiece(diagonal.first);
+            const int secondPiece = findPiece(diagonal.second);
+            if (firstPiece == secondPiece)
+                continue;
+
+            std::vector<int>& first = pieces[firstPiece];
+            std::vector<int>& second = pieces[secondPiece];
+            const int firstCount = static_cast<int>(first.size());
+            const int secondCount = static_cast<int>(second.size());
+            if (firstCount + secondCount - 2 > maxPieceVertices)
+                continue;
+
+            //The shared edge runs a -> b in the first piece and b -> a in the second one
+            int firstA = -1;
+            int secondB = -1;
+            for (int i = 0; i < firstCount && firstA == -1; i++)
+            {
+                const int a = first[i];
+                const int b = first[(i + 1) % firstCount];
+                for (int j = 0; j < secondCount; j++)
+                {
+                    if (second[j] == b && second[(j + 1) % secondCount] == a)
+                    {
+                        firstA = i;
+                        secondB = j;
+                        break;
+                    }
+                }
+            }
+            if (firstA == -1)
+                continue;
+
+            //Only the two ends of the removed edge can turn reflex
+            const int a = first[firstA];
+            const int b = first[(firstA + 1) % firstCount];
+            const int beforeA = first[CircularIndex(firstA - 1, firstCount)];
+            const int afterA = second[(secondB + 2) % secondCount];
+            const int beforeB = second[CircularIndex(secondB - 1, secondCount)];
+            const int afterB = first[(firstA + 2) % firstCount];
+            if (OrientationSign(points[beforeA], points[a], points[afterA]) < 0 ||
+                OrientationSign(points[beforeB], points[b], points[afterB]) < 0)
+                continue;
+
+            //b ... a from the first piece followed by the part of the second piece between a and b
+            merged.clear();
+            for (int i = 0; i < firstCount; i++)
+            {
+                merged.push_back(first[(firstA + 1 + i) % firstCount]);
+            }
+            for (int j = 2; j < secondCount; j++)
+            {
+                merged.push_back(second[(secondB + j) % secondCount]);
+            }
+
+            first.swap(merged);
+            second.clear();
+            pieceParents[secondPiece] = firstPiece;
+        }
+
+        for (std::vector<int>& piece : pieces)
+        {
+            if (!piece.empty())
+                outPieces.push_back(std::move(piece));
+        }
+    }
+
+    void AreaQueryGrid::Build(const std::vector<Vector3>& points, const std::vector<int>& indices,
+                              const std::vector<int>& holeStarts)
+    {
+        Reset();
+        if (points.size() < 3 || indices.size() < 3)
+            return;
+
+        Points = points;
+        Indices = indices;
+
+        MinX = MaxX = points[0].X;
+        MinY = MaxY = points[0].Y;
+        for (const Vector3& point : points)
+        {
+            MinX = std::min(MinX, point.X);
+            MinY = std::min(MinY, point.Y);
+            MaxX = std::max(MaxX, point.X);
+            MaxY = std::max(MaxY, point.Y);
+        }
+
+        //Aim for roughly one triangle per cell
+        const float width = MaxX - MinX;
+        const float height = MaxY - MinY;
+        const int triangleCount = static_cast<int>(indices.size()) / 3;
+        CellSize = std::sqrt(width * height / triangleCount);
+        CellSize = std::max(CellSize, std::max(width, height) / 256.f);
+        CellSize = std::max(CellSize, 1.e-4f);
+        CellCountX = static_cast<int>(width / CellSize) + 1;
+        CellCountY = static_cast<int>(height / CellSize) + 1;
+
+        //Items get counted per cell first, then the counts become offsets and the items get filled in
+        auto fillCells = [this](const int itemCount, std::vector<int>& cellStarts, std::vector<int>& cellItems,
+                                auto&& getBounds)
+        {
+            cellStarts.assign(CellCountX * CellCountY + 1, 0);
+            for (int pass = 0; pass < 2; pass++)
+            {
+                for (int item = 0; item < itemCount; item++)
+                {
+                    float minX, minY, maxX, maxY;
+                    getBounds(item, minX, minY, maxX, maxY);
+                    for (int cellY = CellY(minY); cellY <= CellY(maxY); cellY++)
+                    {
+                        for (int cellX = CellX(minX); cellX <= CellX(maxX); cellX++)
+                        {
+                            const int cell = cellY * CellCountX + cellX;
+                            if (pass == 0)
+                                cellStarts[cell + 1]++;
+                            else
+                                cellItems[cellStarts[cell]++] = item;
+                        }
+                    }
+                }
+
+                if (pass == 0)
+                {
+                    for (size_t cell = 1; cell < cellStarts.size(); cell++)
+                    {
+                        cellStarts[cell] += cellStarts[cell - 1];
+                    }
+                    cellItems.resize(cellStarts.back());
+                }
+                else
+                {
+                    //Filling moved every start onto the start of the next cell
+                    for (size_t cell = cellStarts.size() - 1; cell > 0; cell--)
+                    {
+                        cellStarts[cell] = cellStarts[cell - 1];
+                    }
+                    cellStarts[0] = 0;
+                }
+            }
+        };
+
+        fillCells(triangleCount, TriangleCellStarts, TriangleCellItems,
+                  [this](const int triangle, float& minX, float& minY, float& maxX, float& maxY)
+                  {
+                      const Vector3& a = Points[Indices[triangle * 3]];
+                      const Vector3& b = Points[Indices[triangle * 3 + 1]];
+                      const Vector3& c = Points[Indices[triangle * 3 + 2]];
+                      minX = std::min(std::min(a.X, b.X), c.X);
+                      minY = std::min(std::min(a.Y, b.Y), c.Y);
+                      maxX = std::max(std::max(a.X, b.X), c.X);
+                      maxY = std::max(std::max(a.Y, b.Y), c.Y);
+                  });
+
+        //Every loop closes on its own first point
+        const int pointCount = static_cast<int>(Points.size());
+        EdgeEnds.resize(pointCount);
+        for (int loop = 0; loop <= static_cast<int>(holeStarts.size()); loop++)
+        {
+            const int begin = loop > 0 ? holeStarts[loop - 1] : 0;
+            const int end = loop < static_cast<int>(holeStarts.size()) ? holeStarts[loop] : pointCount;
+            for (int edge = begin; edge < end; edge++)
+            {
+                EdgeEnds[edge] = edge + 1 < end ? edge + 1 : begin;
+            }
+        }
+
+        fillCells(pointCount, EdgeCellStarts, EdgeCellItems,
+                  [this](const int edge, float& minX, float& minY, float& maxX, float& maxY)
+                  {
+                      const Vector3& a = Points[edge];
+                      const Vector3& b = Points[EdgeEnds[edge]];
+                      minX = std::min(a.X, b.X);
+                      minY = std::min(a.Y, b.Y);
+                      maxX = std::max(a.X, b.X);
+                      maxY = std::max(a.Y, b.Y);
+                  });
+    }
+
+    void AreaQueryGrid::Reset()
+    {
+        Points.clear();
+        Indices.clear();
+        EdgeEnds.clear();
+        CellCountX = 0;
+        CellCountY = 0;
+        TriangleCellStarts.clear();
+        TriangleCellItems.clear();
+        EdgeCellStarts.clear();
+        EdgeCellItems.clear();
+    }
+
+    bool AreaQueryGrid::IsEmpty() const
+    {
+        return CellCountX == 0;
+    }
+
+    int AreaQueryGrid::FindTriangle(const float x, const float y, float& outHeight) const
+    {
+        if (IsEmpty() || x < MinX || x > MaxX || y < MinY || y > MaxY)
+            return -1;
+
+        const Vector3 point = {x, y, 0.f};
+        const int cell = CellY(y) * CellCountX + CellX(x);
+        for (int item = TriangleCellStarts[cell]; item < TriangleCellStarts[cell + 1]; item++)
+        {
+            const int triangle = TriangleCellItems[item];
+            const Vector3& a = Points[Indices[triangle * 3]];
+            const Vector3& b = Points[Indices[triangle * 3 + 1]];
+            const Vector3& c = Points[Indices[triangle * 3 + 2]];
+
+            //Inside when the point lies on the same side of all three edges, points on an edge count as inside
+            const double area = Orientation(a, b, c);
+            const double u = Orientation(b, c, point);
+            const double v = Orientation(c, a, point);
+            const double w = Orientation(a, b, point);
+            const bool bInside = area < 0.0
+                                     ? (u <= 0.0 && v <= 0.0 && w <= 0.0)
+                                     : (u >= 0.0 && v >= 0.0 && w >= 0.0);
+            if (!bInside || area == 0.0)
+                continue;
+
+            outHeight = static_cast<float>((u * a.Z + v * b.Z + w * c.Z) / area);
+            return triangle;
+        }
+        return -1;
+    }
+
+    bool AreaQueryGrid::FindNearestPoint(const float x, const float y, Vector3& outPoint) const
+    {
+        if (IsEmpty())
+            return false;
+
+        float height = 0.f;
+        if (FindTriangle(x, y, height) != -1)
+        {
+            outPoint = {x, y, height};
+            return true;
+        }
+
+        //Search rings of cells around the closest cell until no unvisited cell can hold a closer edge
+        const int centerX = CellX(x);
+        const int centerY = CellY(y);
+        double bestDistanceSquared = -1.0;
+        for (int ring = 0;; ring++)
+        {
+            for (int cellY = std::max(centerY - ring, 0); cellY <= std::min(centerY + ring, CellCountY - 1); cellY++)
+            {
+                const bool bFullRow = cellY == centerY - ring || cellY == centerY + ring;
+                const int step = bFullRow ? 1 : ring * 2;
+                for (int cellX = centerX - ring; cellX <= centerX + ring; cellX += std::max(step, 1))
+                {
+                    if (cellX < 0 || cellX >= CellCountX)
+                        continue;
+
+                    const int cell = cellY * CellCountX + cellX;
+                    for (int item = EdgeCellStarts[cell]; item < EdgeCellStarts[cell + 1]; item++)
+                    {
+                        const int edge = EdgeCellItems[item];
+                        const Vector3& a = Points[edge];
+                        const Vector3& b = Points[EdgeEnds[edge]];
+
+                        const double edgeX = static_cast<double>(b.X) - a.X;
+                        const double edgeY = static_cast<double>(b.Y) - a.Y;
+                        const double lengthSquared = edgeX * edgeX + edgeY * edgeY;
+                        double alpha = lengthSquared > 0.0 ? ((x - a.X) * edgeX + (y - a.Y) * edgeY) / lengthSquared : 0.0;
+                        alpha = std::min(std::max(alpha, 0.0), 1.0);
+
+                        const double closestX = a.X + edgeX * alpha;
+                        const double closestY = a.Y + edgeY * alpha;
+                        const double distanceSquared = (closestX - x) * (closestX - x) + (closestY - y) * (closestY - y);
+                        if (bestDistanceSquared < 0.0 || distanceSquared < bestDistanceSquared)
+                        {
+                            bestDistanceSquared = distanceSquared;
+                            outPoint = {
+                                static_cast<float>(closestX), static_cast<float>(closestY),
+                                static_cast<float>(a.Z + (static_cast<double>(b.Z) - a.Z) * alpha)
+                            };
+                        }
+                    }
+                }
+            }
+
+            //Distance to the closest cell that is not visited yet, cells past the grid border do not exist
+            double lowerBound = -1.0;
+            auto addBound = [&lowerBound](const bool bCellsLeft, const double distance)
+            {
+                if (bCellsLeft && (lowerBound < 0.0 || distance < lowerBound))
+                    lowerBound = std::max(distance, 0.0);
+            };
+            addBound(centerX - ring > 0, x - (MinX + (centerX - ring) * CellSize));
+            addBound(centerX + ring < CellCountX - 1, MinX + (centerX + ring + 1) * CellSize - x);
+            addBound(centerY - ring > 0, y - (MinY + (centerY - ring) * CellSize));
+            addBound(centerY + ring < CellCountY - 1, MinY + (centerY + ring + 1) * CellSize - y);
+
+            if (lowerBound < 0.0 || (bestDistanceSquared >= 0.0 && bestDistanceSquared <= lowerBound * lowerBound))
+                break;
+        }
+        return bestDistanceSquared >= 0.0;
+    }
+
+    int AreaQueryGrid::CellX(const float x) const
+    {
+        return std::min(std::max(static_cast<int>(std::floor((x - MinX) / CellSize)), 0), CellCountX - 1);
+    }
+
+    int AreaQueryGrid::CellY(const float y) const
+    {
+        return std::min(std::max(static_cast<int>(std::floor((y - MinY) / CellSize)), 0), CellCountY - 1);
+    }
+}
@@ -0,0 +1,1189 @@
+// Copyright 2021 Robin Smekens
+
+#include "SplineAreaGeometryCorpus.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <limits>
+#include <unordered_map>
+
+//Only the editor and the standalone benchmark run the corpus, shipping builds leave it out
+#if !UE_BUILD_SHIPPING
+
+namespace SplineAreaGeometryCorpus
+{
+    namespace
+    {
+        const float Pi = 3.14159265358979323846f;
+
+        double SecondsSince(const std::chrono::steady_clock::time_point startTime)
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        }
+
+        /// <summary>
+        /// Signed area of the points from begin up to end, positive for counter clockwise loops. Doubles keep the areas of
+        /// large polygons exact enough to compare
+        /// </summary>
+        double LoopArea(const std::vector<Vector3>& points, const int begin, const int end)
+        {
+            double area = 0.0;
+            for (int i = begin; i < end; i++)
+            {
+                const Vector3& point = points[i];
+                const Vector3& nextPoint = points[i + 1 < end ? i + 1 : begin];
+                area += static_cast<double>(point.X) * nextPoint.Y - static_cast<double>(nextPoint.X) * point.Y;
+            }
+            return area * 0.5;
+        }
+
+        /// <summary>
+        /// Counter clockwise axis aligned rectangle
+        /// </summary>
+        std::vector<Vector3> MakeSquare(const float minX, const float minY, const float maxX, const float maxY)
+        {
+            return {{minX, minY, 0.f}, {maxX, minY, 0.f}, {maxX, maxY, 0.f}, {minX, maxY, 0.f}};
+        }
+
+        std::vector<Vector3> Reversed(const std::vector<Vector3>& points)
+        {
+            return std::vector<Vector3>(points.rbegin(), points.rend());
+        }
+
+        /// <summary>
+        /// Evenly spaced angles with a random radius each, with enough points the polygon contains the circle of about minRadius
+        /// </summary>
+        std::vector<Vector3> MakeRoundPolygon(RandomStream& randomStream, const int pointCount, const float minRadius,
+                                              const float maxRadius)
+        {
+            std::vector<Vector3> points;
+            for (int i = 0; i < pointCount; i++)
+            {
+                const float angle = 2.f * Pi * i / pointCount;
+                const float radius = randomStream.FRandRange(minRadius, maxRadius);
+                points.push_back({radius * std::cos(angle), radius * std::sin(angle), 0.f});
+            }
+            return points;
+        }
+
+        /// <summary>
+        /// Corners of every triangle by position, sorted within the triangle and over the triangles. Equal for two
+        /// triangulations that give the same triangles, whatever indices and winding they used
+        /// </summary>
+        std::vector<std::array<float, 6>> TriangleCorners(const std::vector<Vector3>& points, const std::vector<int>& indices)
+        {
+            std::vector<std::array<float, 6>> triangles;
+            for (size_t i = 0; i + 2 < indices.size(); i += 3)
+            {
+                std::array<std::pair<float, float>, 3> corners;
+                for (int corner = 0; corner < 3; corner++)
+                {
+                    const Vector3& point = points[indices[i + corner]];
+                    corners[corner] = {point.X, point.Y};
+                }
+                std::sort(corners.begin(), corners.end());
+                triangles.push_back({corners[0].first, corners[0].second, corners[1].first, corners[1].second,
+                                     corners[2].first, corners[2].second});
+            }
+            std::sort(triangles.begin(), triangles.end());
+            return triangles;
+        }
+
+        /// <summary>
+        /// Triangulates every piece of a union with its holes and validates it, the pieces together have to cover area
+        /// </summary>
+        bool ValidateUnionPieces(const CorpusLog& log, const std::string& caseName,
+                                 const std::vector<SplineAreaGeometry::PolygonUnionPiece>& pieces, const double area)
+        {
+            double piecesArea = 0.0;
+            std::vector<Vector3> points;
+            std::vector<int> holeStarts;
+            std::vector<int> indices;
+            for (const SplineAreaGeometry::PolygonUnionPiece& piece : pieces)
+            {
+                points = piece.Outer;
+                holeStarts.clear();
+                piecesArea += LoopArea(points, 0, static_cast<int>(points.size()));
+                for (const std::vector<Vector3>& hole : piece.Holes)
+                {
+                    holeStarts.push_back(static_cast<int>(points.size()));
+                    points.insert(points.end(), hole.begin(), hole.end());
+                    piecesArea += LoopArea(points, holeStarts.back(), static_cast<int>(points.size()));
+                }
+
+                indices.clear();
+                SplineAreaGeometry::TriangulatePolygonWithHoles(points, holeStarts, indices);
+                std::string error;
+                if (!ValidateTriangulation(points, holeStarts, indices, error))
+                {
+                    log.Error(Format("%s: piece with %d points: %s", caseName.c_str(), static_cast<int>(points.size()),
+                                     error.c_str()));
+                    return false;
+                }
+            }
+
+            if (std::abs(piecesArea - area) > std::max(area * 1.e-5, 1.e-2))
+            {
+                log.Error(Format("%s: the pieces cover %.3f, the union is %.3f", caseName.c_str(), piecesArea, area));
+                return false;
+            }
+            return true;
+        }
+
+        /// <summary>
+        /// Validates the triangulation after a local update and compares the updated adjacency against a fresh one
+        /// </summary>
+        bool ValidateEdit(const std::vector<Vector3>& points, const std::vector<int>& indices,
+                          const SplineAreaGeometry::PointTriangleAdjacency& adjacency, std::string& outError)
+        {
+            if (!ValidateTriangulation(points, std::vector<int>(), indices, outError))
+                return false;
+
+            SplineAreaGeometry::PointTriangleAdjacency freshAdjacency;
+            freshAdjacency.Build(static_cast<int>(points.size()), indices);
+            if (adjacency.GetPointCount() != freshAdjacency.GetPointCount())
+            {
+                outError = Format("adjacency holds %d points, expected %d", adjacency.GetPointCount(),
+                                  freshAdjacency.GetPointCount());
+                return false;
+            }
+
+            std::vector<int> triangles;
+            std::vector<int> freshTriangles;
+            for (int i = 0; i < adjacency.GetPointCount(); i++)
+            {
+                triangles = adjacency.GetTriangles(i);
+                freshTriangles = freshAdjacency.GetTriangles(i);
+                std::sort(triangles.begin(), triangles.end());
+                std::sort(freshTriangles.begin(), freshTriangles.end());
+                if (triangles != freshTriangles)
+                {
+                    outError = Format("adjacency of point %d does not match the triangles", i);
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// <summary>
+        /// Edge from the lower to the higher point index that the triangles and the loops did not cancel out, Count times
+        /// </summary>
+        struct ResidualEdge
+        {
+            int From;
+            int To;
+            int Count;
+        };
+
+        /// <summary>
+        /// A bridge that lines up with an edge of its loop leaves a point on a straight line that the triangulation skips, so
+        /// a triangle edge spans the loop edges on both sides of it. Such edges still cancel out along the line they share:
+        /// sorted along every line the edges have to cover each stretch as often in one direction as in the other
+        /// </summary>
+        bool CancelCollinearEdges(const std::vector<Vector3>& points, const std::vector<ResidualEdge>& edges, std::string& outError)
+        {
+            //Only a handful of points ever line up like this, a long list means something else went wrong
+            const int edgeCount = static_cast<int>(edges.size());
+            if (edgeCount > 1000)
+            {
+                outError = Format("%d edges are not shared by the triangles on both sides", edgeCount);
+                return false;
+            }
+
+            std::vector<unsigned char> bChecked(edgeCount, 0);
+            std::vector<std::pair<double, int>> events;
+            for (int i = 0; i < edgeCount; i++)
+            {
+                if (bChecked[i])
+                    continue;
+
+                const Vector3& lineStart = points[edges[i].From];
+                const Vector3& lineEnd = points[edges[i].To];
+                const double directionX = static_cast<double>(lineEnd.X) - lineStart.X;
+                const double directionY = static_cast<double>(lineEnd.Y) - lineStart.Y;
+                const auto lineParameter = [&](const Vector3& point)
+                {
+                    return (point.X - static_cast<double>(lineStart.X)) * directionX +
+                        (point.Y - static_cast<double>(lineStart.Y)) * directionY;
+                };
+
+                events.clear();
+                for (int j = i; j < edgeCount; j++)
+                {
+                    const Vector3& from = points[edges[j].From];
+                    const Vector3& to = points[edges[j].To];
+                    if (bChecked[j] || SplineAreaGeometry::OrientationSign(lineStart, lineEnd, from) != 0 ||
+                        SplineAreaGeometry::OrientationSign(lineStart, lineEnd, to) != 0)
+                        continue;
+
+                    bChecked[j] = 1;
+                    const double fromParameter = lineParameter(from);
+                    const double toParameter = lineParameter(to);
+                    const int count = fromParameter < toParameter ? edges[j].Count : -edges[j].Count;
+                    events.push_back({std::min(fromParameter, toParameter), count});
+                    events.push_back({std::max(fromParameter, toParameter), -count});
+                }
+                std::sort(events.begin(), events.end());
+
+                int coverage = 0;
+                for (size_t j = 0; j < events.size(); j++)
+                {
+                    coverage += events[j].second;
+                    if (coverage != 0 && (j + 1 == events.size() || events[j + 1].first != events[j].first))
+                    {
+                        outError = Format("edge %d-%d is not shared by the triangles on both sides", edges[i].From, edges[i].To);
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        struct BenchmarkShape
+        {
+            const char* Name;
+            std::vector<Vector3> (*Generate)(int);
+            std::vector<int> PointCounts;
+        };
+
+        /// <summary>
+        /// Triangulates the polygon a few times with a fresh triangulator and logs the time spent per stage and the allocations,
+        /// returns false if the result is not valid
+        /// </summary>
+        bool RunBenchmarkCase(const CorpusLog& log, const char* shapeName, const std::vector<Vector3>& points,
+                              double& outSecondsPerRun)
+        {
+            const int pointCount = static_cast<int>(points.size());
+            const int iterationCount = std::min(std::max(20000 / pointCount, 1), 50);
+
+            //The first run grows the scratch buffers, every later run should reuse them
+            SplineAreaGeometry::Triangulator triangulator;
+            SplineAreaGeometry::TriangulationStats stats;
+            int firstRunAllocations = 0;
+            int laterRunAllocations = 0;
+            double componentSeconds = 0.0;
+            double clippingSeconds = 0.0;
+
+            std::vector<int> indices;
+            indices.reserve((pointCount - 2) * 3);
+            for (int iteration = 0; iteration < iterationCount; iteration++)
+            {
+                indices.clear();
+
+                std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+                triangulator.ClassifyPoints(points);
+                componentSeconds += SecondsSince(startTime);
+
+                startTime = std::chrono::steady_clock::now();
+                triangulator.ClipEars(points, indices, &stats);
+                clippingSeconds += SecondsSince(startTime);
+
+                if (iteration == 0)
+                    firstRunAllocations = stats.Allocations;
+                else
+                    laterRunAllocations = std::max(laterRunAllocations, stats.Allocations);
+            }
+
+            const int triangleCount = static_cast<int>(indices.size()) / 3;
+            outSecondsPerRun = (componentSeconds + clippingSeconds) / iterationCount;
+            log.Info(Format("%-10s n=%6d components %8.3f ms  clipping %8.3f ms  %10.0f triangles/s  "
+                            "allocations %d first, %d later  scratch %6d KB",
+                            shapeName, pointCount, 1000.0 * componentSeconds / iterationCount,
+                            1000.0 * clippingSeconds / iterationCount, triangleCount / std::max(outSecondsPerRun, 1.e-9),
+                            firstRunAllocations, laterRunAllocations, stats.ScratchBytes / 1024));
+
+            std::string error;
+            if (!ValidateTriangulation(points, std::vector<int>(), indices, error))
+            {
+                log.Error(Format("%s n=%d: %s", shapeName, pointCount, error.c_str()));
+                return false;
+            }
+            if (laterRunAllocations > 0)
+            {
+                log.Error(Format("%s n=%d: %d allocations after the scratch buffers fit the polygon", shapeName, pointCount,
+                                 laterRunAllocations));
+                return false;
+            }
+            return true;
+        }
+    }
+
+    RandomStream::RandomStream(const uint32_t seed)
+        : Seed(seed)
+    {
+    }
+
+    float RandomStream::FRandRange(const float min, const float max)
+    {
+        Seed = Seed * 196314165u + 907633515u;
+        const float fraction = static_cast<float>(Seed >> 8) * (1.f / 16777216.f);
+        return min + (max - min) * fraction;
+    }
+
+    int RandomStream::RandRange(const int min, const int max)
+    {
+        const int range = max - min + 1;
+        return min + std::min(static_cast<int>(FRandRange(0.f, static_cast<float>(range))), range - 1);
+    }
+
+    std::string Format(const char* format, ...)
+    {
+        char buffer[512];
+        va_list arguments;
+        va_start(arguments, format);
+        vsnprintf(buffer, sizeof(buffer), format, arguments);
+        va_end(arguments);
+        return buffer;
+    }
+
+    std::vector<Vector3> MakeConvexPolygon(const int pointCount)
+    {
+        std::vector<Vector3> points;
+        for (int i = 0; i < pointCount; i++)
+        {
+            const float angle = 2.f * Pi * i / pointCount;
+            points.push_back({1000.f * std::cos(angle), 1000.f * std::sin(angle), 0.f});
+        }
+        return points;
+    }
+
+    std::vector<Vector3> MakeStarPolygon(const int pointCount)
+    {
+        std::vector<Vector3> points;
+        for (int i = 0; i < pointCount; i++)
+        {
+            const float angle = 2.f * Pi * i / pointCount;
+            const float radius = (i % 2 == 0) ? 1000.f : 400.f;
+            points.push_back({radius * std::cos(angle), radius * std::sin(angle), 0.f});
+        }
+        return points;
+    }
+
+    std::vector<Vector3> MakeSpiralPolygon(const int pointCount)
+    {
+        const int armCount = pointCount / 2;
+        const float turns = 4.f;
+        const float spacing = 30.f;
+        const float bandWidth = 15.f;
+
+        std::vector<Vector3> points;
+        for (int i = 0; i < armCount; i++)
+        {
+            const float angle = 2.f * Pi * turns * i / armCount;
+            const float radius = 50.f + spacing * angle / (2.f * Pi) + bandWidth;
+            points.push_back({radius * std::cos(angle), radius * std::sin(angle), 0.f});
+        }
+        for (int i = armCount - 1; i >= 0; i--)
+        {
+            const float angle = 2.f * Pi * turns * i / armCount;
+            const float radius = 50.f + spacing * angle / (2.f * Pi);
+            points.push_back({radius * std::cos(angle), radius * std::sin(angle), 0.f});
+        }
+        return points;
+    }
+
+    std::vector<Vector3> MakeCombPolygon(const int pointCount)
+    {
+        const int teethCount = std::max(1, pointCount / 4);
+        const float toothWidth = 5.f;
+        const float length = teethCount * toothWidth * 2.f - toothWidth;
+
+        std::vector<Vector3> points;
+        points.push_back({0.f, 0.f, 0.f});
+        points.push_back({length, 0.f, 0.f});
+        for (int i = teethCount - 1; i >= 0; i--)
+        {
+            const float toothStart = i * toothWidth * 2.f;
+            points.push_back({toothStart + toothWidth, 110.f, 0.f});
+            points.push_back({toothStart, 110.f, 0.f});
+            if (i > 0)
+            {
+                points.push_back({toothStart, 10.f, 0.f});
+                points.push_back({toothStart - toothWidth, 10.f, 0.f});
+            }
+        }
+        return points;
+    }
+
+    std::vector<Vector3> MakeCoastlinePolygon(const int pointCount)
+    {
+        RandomStream randomStream(pointCount);
+
+        std::vector<Vector3> points;
+        for (int i = 0; i < pointCount; i++)
+        {
+            const float angle = 2.f * Pi * i / pointCount;
+            const float radius = 5000.f + 400.f * std::sin(angle * 7.f) + randomStream.FRandRange(-300.f, 300.f);
+            points.push_back({radius * std::cos(angle), radius * std::sin(angle), 0.f});
+        }
+        return points;
+    }
+
+    std::vector<Vector3> MakeNearTouchingCombPolygon(const int pointCount)
+    {
+        const int teethCount = std::max(1, pointCount / 4);
+        const float toothWidth = 5.f;
+        const float toothPitch = toothWidth + 0.01f;
+        const float length = (teethCount - 1) * toothPitch + toothWidth;
+
+        std::vector<Vector3> points;
+        points.push_back({0.f, 0.f, 0.f});
+        points.push_back({length, 0.f, 0.f});
+        for (int i = teethCount - 1; i >= 0; i--)
+        {
+            const float toothStart = i * toothPitch;
+            points.push_back({toothStart + toothWidth, 110.f, 0.f});
+            points.push_back({toothStart, 110.f, 0.f});
+            if (i > 0)
+            {
+                points.push_back({toothStart, 10.f, 0.f});
+                points.push_back({toothStart - 0.01f, 10.f, 0.f});
+            }
+        }
+        return points;
+    }
+
+    std::vector<Vector3> MakeRandomStarPolygon(RandomStream& randomStream, const int pointCount)
+    {
+        //A gap of half a turn or more between two angles lets the closing edge cut through the others, those get drawn again
+        std::vector<float> angles(pointCount);
+        bool bHalfTurnGap = true;
+        while (bHalfTurnGap)
+        {
+            for (float& angle : angles)
+            {
+                angle = randomStream.FRandRange(0.f, 2.f * Pi);
+            }
+            std::sort(angles.begin(), angles.end());
+
+            bHalfTurnGap = angles.front() + 2.f * Pi - angles.back() >= Pi;
+            for (int i = 1; i < pointCount; i++)
+            {
+                bHalfTurnGap |= angles[i] - angles[i - 1] >= Pi;
+            }
+        }
+
+        std::vector<Vector3> points;
+        for (const float angle : angles)
+        {
+            const float radius = randomStream.FRandRange(100.f, 1000.f);
+            points.push_back({radius * std::cos(angle), radius * std::sin(angle), 0.f});
+        }
+        return points;
+    }
+
+    std::vector<Vector3> MakeRandomMonotonePolygon(RandomStream& randomStream, const int pointCount)
+    {
+        std::vector<float> xs(std::max(pointCount, 3));
+        for (float& x : xs)
+        {
+            x = randomStream.FRandRange(0.f, 1000.f);
+        }
+        std::sort(xs.begin(), xs.end());
+
+        const int lastIndex = static_cast<int>(xs.size()) - 1;
+        std::vector<Vector3> points;
+        points.push_back({xs[0], 0.f, 0.f});
+        for (int i = 1; i < lastIndex; i += 2)
+        {
+            points.push_back({xs[i], randomStream.FRandRange(-500.f, -1.f), 0.f});
+        }
+        points.push_back({xs[lastIndex], 0.f, 0.f});
+        for (int i = lastIndex - 1; i > 0; i--)
+        {
+            if (i % 2 == 0)
+                points.push_back({xs[i], randomStream.FRandRange(1.f, 500.f), 0.f});
+        }
+        return points;
+    }
+
+    void AddDuplicatePoints(RandomStream& randomStream, std::vector<Vector3>& points)
+    {
+        std::vector<Vector3> result;
+        for (const Vector3& point : points)
+        {
+            result.push_back(point);
+            if (randomStream.RandRange(0, 3) == 0)
+                result.insert(result.end(), randomStream.RandRange(1, 3), point);
+        }
+        points.swap(result);
+    }
+
+    void AddCollinearRuns(RandomStream& randomStream, std::vector<Vector3>& points)
+    {
+        const int pointCount = static_cast<int>(points.size());
+        std::vector<Vector3> result;
+        for (int i = 0; i < pointCount; i++)
+        {
+            const Vector3& start = points[i];
+            const Vector3& end = points[(i + 1) % pointCount];
+            result.push_back(start);
+            if (randomStream.RandRange(0, 2) != 0)
+                continue;
+
+            const int runLength = randomStream.RandRange(1, 5);
+            for (int j = 1; j <= runLength; j++)
+            {
+                const float alpha = static_cast<float>(j) / (runLength + 1);
+                result.push_back({start.X + (end.X - start.X) * alpha, start.Y + (end.Y - start.Y) * alpha, 0.f});
+            }
+        }
+        points.swap(result);
+    }
+
+    bool ValidateTriangulation(const std::vector<Vector3>& points, const std::vector<int>& holeStarts,
+                               const std::vector<int>& indices, std::string& outError)
+    {
+        //Signed edge counts, the edge from a to b counts +1 when a < b and -1 the other way around
+        std::unordered_map<uint64_t, int> edgeCounts;
+        edgeCounts.reserve(indices.size() * 2);
+        const auto countEdge = [&edgeCounts](const int from, const int to, const int amount)
+        {
+            const uint64_t key = (static_cast<uint64_t>(std::min(from, to)) << 32) | static_cast<uint32_t>(std::max(from, to));
+            edgeCounts[key] += from < to ? amount : -amount;
+        };
+
+        //Every loop cleaned on its own, the outline gets walked counter clockwise and the holes clockwise
+        const int pointCount = static_cast<int>(points.size());
+        const int loopCount = static_cast<int>(holeStarts.size()) + 1;
+        int expectedTriangles = 0;
+        double polygonArea = 0.0;
+        std::vector<Vector3> loopPoints;
+        SplineAreaGeometry::PolygonComponents components;
+        for (int loop = 0; loop < loopCount; loop++)
+        {
+            const int begin = loop > 0 ? holeStarts[loop - 1] : 0;
+            const int end = loop < loopCount - 1 ? holeStarts[loop] : pointCount;
+            loopPoints.assign(points.begin() + begin, points.begin() + end);
+            SplineAreaGeometry::GetPolygonComponents(loopPoints, components);
+
+            const std::vector<int>& ring = components.RingIndices;
+            const int ringCount = static_cast<int>(ring.size());
+            if (ringCount < 3)
+            {
+                if (loop == 0)
+                    break;
+                continue;
+            }
+
+            expectedTriangles += loop == 0 ? ringCount - 2 : ringCount + 2;
+            polygonArea += (loop == 0 ? 1.0 : -1.0) * std::abs(LoopArea(points, begin, end));
+            for (int i = 0; i < ringCount; i++)
+            {
+                const int from = begin + ring[i];
+                const int to = begin + ring[(i + 1) % ringCount];
+                if (loop == 0)
+                    countEdge(from, to, -1);
+                else
+                    countEdge(to, from, -1);
+            }
+        }
+
+        const int triangleCount = static_cast<int>(indices.size()) / 3;
+        if (triangleCount > expectedTriangles)
+        {
+            outError = Format("%d triangles, expected %d", triangleCount, expectedTriangles);
+            return false;
+        }
+
+        double triangleArea = 0.0;
+        for (int i = 0; i < triangleCount; i++)
+        {
+            const int index1 = indices[i * 3];
+            const int index2 = indices[i * 3 + 1];
+            const int index3 = indices[i * 3 + 2];
+            if (SplineAreaGeometry::OrientationSign(points[index1], points[index2], points[index3]) > 0)
+            {
+                outError = Format("triangle %d winds the same way as the polygon", i);
+                return false;
+            }
+
+            const Vector3& t1 = points[index1];
+            const Vector3& t2 = points[index2];
+            const Vector3& t3 = points[index3];
+            triangleArea -= 0.5 * ((static_cast<double>(t2.X) - t1.X) * (static_cast<double>(t3.Y) - t1.Y) -
+                (static_cast<double>(t3.X) - t1.X) * (static_cast<double>(t2.Y) - t1.Y));
+
+            //Walked backwards, so the edges run the same way as the outline
+            countEdge(index1, index3, 1);
+            countEdge(index3, index2, 1);
+            countEdge(index2, index1, 1);
+        }
+
+        if (std::abs(triangleArea - polygonArea) > std::max(std::abs(polygonArea) * 1.e-6, 1.e-3))
+        {
+            outError = Format("triangles cover %.3f, polygon area is %.3f", triangleArea, polygonArea);
+            return false;
+        }
+
+        std::vector<ResidualEdge> residualEdges;
+        for (const std::pair<const uint64_t, int>& edgeCount : edgeCounts)
+        {
+            if (edgeCount.second != 0)
+                residualEdges.push_back({static_cast<int>(edgeCount.first >> 32), static_cast<int>(edgeCount.first & 0xffffffffu),
+                                         edgeCount.second});
+        }
+        if (residualEdges.empty())
+        {
+            if (triangleCount == expectedTriangles)
+                return true;
+            outError = Format("%d triangles, expected %d", triangleCount, expectedTriangles);
+            return false;
+        }
+        return CancelCollinearEdges(points, residualEdges, outError);
+    }
+
+    double FitScalingExponent(const std::vector<int>& pointCounts, const std::vector<double>& seconds)
+    {
+        const int sampleCount = static_cast<int>(pointCounts.size());
+        double meanX = 0.0;
+        double meanY = 0.0;
+        for (int i = 0; i < sampleCount; i++)
+        {
+            meanX += std::log(static_cast<double>(pointCounts[i])) / sampleCount;
+            meanY += std::log(std::max(seconds[i], 1.e-9)) / sampleCount;
+        }
+
+        double covariance = 0.0;
+        double variance = 0.0;
+        for (int i = 0; i < sampleCount; i++)
+        {
+            const double x = std::log(static_cast<double>(pointCounts[i])) - meanX;
+            covariance += x * (std::log(std::max(seconds[i], 1.e-9)) - meanY);
+            variance += x * x;
+        }
+        return variance > 0.0 ? covariance / variance : 0.0;
+    }
+
+    int RunBenchmark(const CorpusLog& log)
+    {
+        const BenchmarkShape shapes[] = {
+            {"Convex", &MakeConvexPolygon, {250, 1000, 4000}},
+            {"Star", &MakeStarPolygon, {250, 1000, 4000}},
+            {"Spiral", &MakeSpiralPolygon, {250, 1000, 4000}},
+            {"Comb", &MakeCombPolygon, {250, 1000, 4000}},
+            {"Coastline", &MakeCoastlinePolygon, {1000, 4000, 10000}},
+        };
+
+        int failureCount = 0;
+        for (const BenchmarkShape& shape : shapes)
+        {
+            std::vector<int> pointCounts;
+            std::vector<double> timings;
+            for (const int requestedPointCount : shape.PointCounts)
+            {
+                const std::vector<Vector3> points = shape.Generate(requestedPointCount);
+
+                double seconds = 0.0;
+                if (!RunBenchmarkCase(log, shape.Name, points, seconds))
+                    failureCount++;
+                pointCounts.push_back(static_cast<int>(points.size()));
+                timings.push_back(seconds);
+            }
+
+            //Slope of the time against point count on a log-log scale, 2 is quadratic
+            log.Info(Format("%-10s scaling n=%d -> n=%d ~ O(n^%.2f)", shape.Name, pointCounts.front(), pointCounts.back(),
+                            FitScalingExponent(pointCounts, timings)));
+        }
+
+        if (failureCount > 0)
+            log.Error(Format("SplineArea benchmark finished with %d invalid results", failureCount));
+        else
+            log.Info("SplineArea benchmark finished, all results valid");
+        return failureCount;
+    }
+
+    int RunStressTest(const CorpusLog& log, const uint32_t seed, const int caseCount)
+    {
+        RandomStream randomStream(seed);
+        int failureCount = 0;
+        std::vector<int> indices;
+        std::vector<int> clockwiseIndices;
+        for (int caseIndex = 0; caseIndex < caseCount; caseIndex++)
+        {
+            const int pointCount = randomStream.RandRange(3, 300);
+            std::vector<Vector3> points;
+            const char* variant = "simple";
+            switch (caseIndex % 6)
+            {
+            case 0:
+                points = MakeRandomStarPolygon(randomStream, pointCount);
+                break;
+            case 1:
+                points = MakeRandomMonotonePolygon(randomStream, pointCount);
+                break;
+            case 2:
+                points = MakeRandomStarPolygon(randomStream, pointCount);
+                AddDuplicatePoints(randomStream, points);
+                variant = "duplicates";
+                break;
+            case 3:
+                points = MakeRandomMonotonePolygon(randomStream, pointCount);
+                AddCollinearRuns(randomStream, points);
+                variant = "collinear";
+                break;
+            case 4:
+                points = MakeRandomStarPolygon(randomStream, pointCount);
+                AddCollinearRuns(randomStream, points);
+                AddDuplicatePoints(randomStream, points);
+                variant = "clockwise";
+                break;
+            default:
+                points = MakeNearTouchingCombPolygon(pointCount);
+                variant = "touching";
+                break;
+            }
+
+            const std::string caseName = Format("seed %u case %d (%s, n=%d)", seed, caseIndex, variant,
+                                                static_cast<int>(points.size()));
+            indices.clear();
+            SplineAreaGeometry::TriangulatePolygon(points, indices);
+            std::string error;
+            if (!ValidateTriangulation(points, std::vector<int>(), indices, error))
+            {
+                log.Error(caseName + ": " + error);
+                failureCount++;
+                continue;
+            }
+            if (caseIndex % 6 != 4)
+                continue;
+
+            //The same polygon the other way around gets cleaned into the same ring, so it has to give the same triangles
+            std::vector<Vector3> clockwisePoints(points.rbegin(), points.rend());
+            clockwiseIndices.clear();
+            SplineAreaGeometry::TriangulatePolygon(clockwisePoints, clockwiseIndices);
+            if (!ValidateTriangulation(clockwisePoints, std::vector<int>(), clockwiseIndices, error))
+            {
+                log.Error(caseName + " reversed: " + error);
+                failureCount++;
+            }
+            else if (TriangleCorners(points, indices) != TriangleCorners(clockwisePoints, clockwiseIndices))
+            {
+                log.Error(caseName + ": the reversed polygon gives different triangles");
+                failureCount++;
+            }
+        }
+        log.Info(Format("SplineArea stress test validated %d random polygons", caseCount));
+        return failureCount;
+    }
+
+    int RunScalingTest(const CorpusLog& log)
+    {
+        //Ear clipping is quadratic in the worst case, anything steeper means a cubic pass crept in
+        const double maxScalingExponent = 2.5;
+
+        const BenchmarkShape shapes[] = {
+            {"Comb", &MakeCombPolygon, {1000, 2000, 4000, 8000, 16000, 32000, 50000}},
+            {"Spiral", &MakeSpiralPolygon, {1000, 2000, 4000, 8000, 16000, 32000, 50000}},
+            {"Touching", &MakeNearTouchingCombPolygon, {1000, 2000, 4000, 8000}},
+            {"Coastline", &MakeCoastlinePolygon, {1000, 2000, 4000, 8000, 16000, 32000, 50000}},
+        };
+
+        int failureCount = 0;
+        std::vector<int> indices;
+        for (const BenchmarkShape& shape : shapes)
+        {
+            std::vector<int> pointCounts;
+            std::vector<double> timings;
+            for (const int requestedPointCount : shape.PointCounts)
+            {
+                const std::vector<Vector3> points = shape.Generate(requestedPointCount);
+                const int pointCount = static_cast<int>(points.size());
+
+                //The fastest of a few runs filters out hitches, large polygons take long enough to time once
+                const int runCount = std::min(std::max(20000 / pointCount, 1), 5);
+                double seconds = std::numeric_limits<double>::max();
+                for (int run = 0; run < runCount; run++)
+                {
+                    indices.clear();
+                    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+                    SplineAreaGeometry::TriangulatePolygon(points, indices);
+                    seconds = std::min(seconds, SecondsSince(startTime));
+                }
+
+                std::string error;
+                if (!ValidateTriangulation(points, std::vector<int>(), indices, error))
+                {
+                    log.Error(Format("%s n=%d: %s", shape.Name, pointCount, error.c_str()));
+                    failureCount++;
+                }
+                pointCounts.push_back(pointCount);
+                timings.push_back(seconds);
+                log.Info(Format("%-10s n=%6d %10.3f ms", shape.Name, pointCount, 1000.0 * seconds));
+            }
+
+            const double exponent = FitScalingExponent(pointCounts, timings);
+            if (exponent > maxScalingExponent)
+            {
+                log.Error(Format("%-10s scales with O(n^%.2f), the limit is O(n^%.2f)", shape.Name, exponent,
+                                 maxScalingExponent));
+                failureCount++;
+            }
+            else
+            {
+                log.Info(Format("%-10s scales with O(n^%.2f)", shape.Name, exponent));
+            }
+        }
+        return failureCount;
+    }
+
+    int RunHoleTest(const CorpusLog& log, const uint32_t seed, const int caseCount)
+    {
+        const std::vector<Vector3> square = MakeSquare(0.f, 0.f, 100.f, 100.f);
+        const std::vector<Vector3> innerHole = MakeSquare(40.f, 40.f, 60.f, 60.f);
+        const std::vector<Vector3> lShape = {
+            {0.f, 0.f, 0.f}, {100.f, 0.f, 0.f}, {100.f, 50.f, 0.f}, {50.f, 50.f, 0.f}, {50.f, 100.f, 0.f}, {0.f, 100.f, 0.f}
+        };
+
+        //Bridges that line up with an edge of the outline leave a collinear point, the top of the notch is slanted instead
+        const std::vector<Vector3> slantedLShape = {
+            {0.f, 0.f, 0.f}, {100.f, 0.f, 0.f}, {100.f, 40.f, 0.f}, {50.f, 50.f, 0.f}, {50.f, 100.f, 0.f}, {0.f, 100.f, 0.f}
+        };
+
+        //Loops of the case, the holes that have to be kept come before the ones that have to be left out
+        struct HoleCase
+        {
+            const char* Name;
+            std::vector<std::vector<Vector3>> Loops;
+            int KeptHoleCount;
+            bool bCrossing;
+        };
+        const HoleCase holeCases[] = {
+            {"inside", {square, innerHole}, 1, false},
+            {"inside clockwise", {square, Reversed(innerHole)}, 1, false},
+            {"corner on the bridge ray", {square, {{40.f, 50.f, 0.f}, {45.f, 40.f, 0.f}, {50.f, 50.f, 0.f}, {45.f, 60.f, 0.f}}},
+             1, false},
+            {"left of the outline", {square, MakeSquare(-50.f, 40.f, -40.f, 60.f)}, 0, false},
+            {"right of the outline", {square, MakeSquare(150.f, 40.f, 160.f, 60.f)}, 0, false},
+            {"inside and left of the outline", {square, innerHole, MakeSquare(-50.f, 40.f, -40.f, 60.f)}, 1, false},
+            {"overlapping the left side", {square, MakeSquare(-10.f, 40.f, 20.f, 60.f)}, 0, true},
+            {"overlapping the right side", {square, MakeSquare(80.f, 40.f, 120.f, 60.f)}, 0, true},
+            {"in the notch", {lShape, MakeSquare(70.f, 70.f, 80.f, 80.f)}, 0, false},
+            {"on the ray through the notch corner", {slantedLShape, {{20.f, 45.f, 0.f}, {30.f, 50.f, 0.f}, {20.f, 55.f, 0.f},
+             {10.f, 50.f, 0.f}}}, 1, false},
+        };
+
+        int failureCount = 0;
+        for (const HoleCase& holeCase : holeCases)
+        {
+            std::vector<Vector3> points;
+            std::vector<int> holeStarts;
+            for (const std::vector<Vector3>& loop : holeCase.Loops)
+            {
+                if (!points.empty())
+                    holeStarts.push_back(static_cast<int>(points.size()));
+                points.insert(points.end(), loop.begin(), loop.end());
+            }
+
+            std::vector<int> indices;
+            SplineAreaGeometry::TriangulationStats stats;
+            SplineAreaGeometry::TriangulatePolygonWithHoles(points, holeStarts, indices, &stats);
+
+            //Left out holes must not show up in the triangles, so the kept loops alone have to validate
+            const int keptPointCount = holeCase.KeptHoleCount < static_cast<int>(holeStarts.size())
+                                           ? holeStarts[holeCase.KeptHoleCount]
+                                           : static_cast<int>(points.size());
+            const std::vector<Vector3> keptPoints(points.begin(), points.begin() + keptPointCount);
+            const std::vector<int> keptHoleStarts(holeStarts.begin(), holeStarts.begin() + holeCase.KeptHoleCount);
+            std::string error;
+            if (!indices.empty() && *std::max_element(indices.begin(), indices.end()) >= keptPointCount)
+            {
+                log.Error(Format("hole %s: a left out hole is part of the triangles", holeCase.Name));
+                failureCount++;
+            }
+            else if (!ValidateTriangulation(keptPoints, keptHoleStarts, indices, error))
+            {
+                log.Error(Format("hole %s: %s", holeCase.Name, error.c_str()));
+                failureCount++;
+            }
+            else if (stats.bSelfIntersecting != holeCase.bCrossing)
+            {
+                log.Error(Format("hole %s: %s flagged as crossing", holeCase.Name, stats.bSelfIntersecting ? "wrongly" : "not"));
+                failureCount++;
+            }
+        }
+
+        //Random holes each within their own cell of a grid that fits inside the outline, so they never touch
+        RandomStream randomStream(seed);
+        const int gridSize = 4;
+        const float cellSize = 300.f;
+        const int outlinePointCount = 32;
+        for (int caseIndex = 0; caseIndex < caseCount; caseIndex++)
+        {
+            std::vector<Vector3> points = MakeRoundPolygon(randomStream, outlinePointCount, 900.f, 1000.f);
+            std::vector<int> holeStarts;
+            for (int cell = 0; cell < gridSize * gridSize; cell++)
+            {
+                if (randomStream.RandRange(0, 2) == 0)
+                    continue;
+
+                const float centerX = (cell % gridSize - 1.5f) * cellSize;
+                const float centerY = (cell / gridSize - 1.5f) * cellSize;
+                std::vector<Vector3> hole = MakeRoundPolygon(randomStream, randomStream.RandRange(3, 12), 30.f, 120.f);
+                for (Vector3& point : hole)
+                {
+                    point.X += centerX;
+                    point.Y += centerY;
+                }
+                if (randomStream.RandRange(0, 1) == 0)
+                    std::reverse(hole.begin(), hole.end());
+
+                holeStarts.push_back(static_cast<int>(points.size()));
+                points.insert(points.end(), hole.begin(), hole.end());
+            }
+            if (caseIndex % 2 == 1)
+                std::reverse(points.begin(), points.begin() + outlinePointCount);
+
+            std::vector<int> indices;
+            SplineAreaGeometry::TriangulatePolygonWithHoles(points, holeStarts, indices);
+            std::string error;
+            if (!ValidateTriangulation(points, holeStarts, indices, error))
+            {
+                log.Error(Format("seed %u hole case %d (%d holes): %s", seed, caseIndex, static_cast<int>(holeStarts.size()),
+                                 error.c_str()));
+                failureCount++;
+            }
+        }
+        log.Info(Format("SplineArea hole test validated %d fixed and %d random outlines",
+                        static_cast<int>(sizeof(holeCases) / sizeof(holeCases[0])), caseCount));
+        return failureCount;
+    }
+
+    int RunUnionTest(const CorpusLog& log, const uint32_t seed, const int caseCount)
+    {
+        struct UnionCase
+        {
+            const char* Name;
+            std::vector<std::vector<Vector3>> Polygons;
+            int PieceCount;
+            int HoleCount;
+            double Area;
+        };
+        std::vector<Vector3> raisedSquare = MakeSquare(50.f, 50.f, 150.f, 150.f);
+        for (Vector3& point : raisedSquare)
+        {
+            point.Z = 300.f;
+        }
+        const UnionCase unionCases[] = {
+            {"overlapping", {MakeSquare(0.f, 0.f, 100.f, 100.f), MakeSquare(50.f, 50.f, 150.f, 150.f)}, 1, 0, 17500.0},
+            {"overlapping clockwise", {MakeSquare(0.f, 0.f, 100.f, 100.f), Reversed(MakeSquare(50.f, 50.f, 150.f, 150.f))},
+             1, 0, 17500.0},
+            {"disjoint", {MakeSquare(0.f, 0.f, 100.f, 100.f), MakeSquare(200.f, 0.f, 300.f, 100.f)}, 2, 0, 20000.0},
+            {"contained", {MakeSquare(0.f, 0.f, 100.f, 100.f), MakeSquare(25.f, 25.f, 75.f, 75.f)}, 1, 0, 10000.0},
+            {"frame", {MakeSquare(0.f, 0.f, 100.f, 20.f), MakeSquare(80.f, 10.f, 100.f, 100.f),
+                       MakeSquare(0.f, 80.f, 90.f, 100.f), MakeSquare(0.f, 10.f, 20.f, 90.f)}, 1, 1, 6400.0},
+            {"stacked", {MakeSquare(0.f, 0.f, 100.f, 100.f), raisedSquare}, 2, 0, 20000.0},
+        };
+
+        int failureCount = 0;
+        std::vector<SplineAreaGeometry::PolygonUnionPiece> pieces;
+        for (const UnionCase& unionCase : unionCases)
+        {
+            SplineAreaGeometry::UnionPolygons(unionCase.Polygons, std::vector<std::vector<int>>(), pieces);
+            int holeCount = 0;
+            for (const SplineAreaGeometry::PolygonUnionPiece& piece : pieces)
+            {
+                holeCount += static_cast<int>(piece.Holes.size());
+            }
+
+            const std::string caseName = Format("union %s", unionCase.Name);
+            if (static_cast<int>(pieces.size()) != unionCase.PieceCount || holeCount != unionCase.HoleCount)
+            {
+                log.Error(Format("%s: %d pieces with %d holes, expected %d with %d", caseName.c_str(),
+                                 static_cast<int>(pieces.size()), holeCount, unionCase.PieceCount, unionCase.HoleCount));
+                failureCount++;
+            }
+            else if (!ValidateUnionPieces(log, caseName, pieces, unionCase.Area))
+            {
+                failureCount++;
+            }
+        }
+
+        //Random rectangles, the area of their union comes from the cells between all of their sides
+        RandomStream randomStream(seed);
+        std::vector<std::vector<Vector3>> polygons;
+        for (int caseIndex = 0; caseIndex < caseCount; caseIndex++)
+        {
+            polygons.clear();
+            std::vector<double> xs;
+            std::vector<double> ys;
+            const int rectangleCount = randomStream.RandRange(2, 12);
+            for (int i = 0; i < rectangleCount; i++)
+            {
+                const float minX = randomStream.FRandRange(0.f, 800.f);
+                const float minY = randomStream.FRandRange(0.f, 800.f);
+                polygons.push_back(MakeSquare(minX, minY, minX + randomStream.FRandRange(20.f, 400.f),
+                                              minY + randomStream.FRandRange(20.f, 400.f)));
+                xs.push_back(polygons.back()[0].X);
+                xs.push_back(polygons.back()[2].X);
+                ys.push_back(polygons.back()[0].Y);
+                ys.push_back(polygons.back()[2].Y);
+            }
+            std::sort(xs.begin(), xs.end());
+            std::sort(ys.begin(), ys.end());
+
+            double area = 0.0;
+            for (size_t x = 0; x + 1 < xs.size(); x++)
+            {
+                for (size_t y = 0; y + 1 < ys.size(); y++)
+                {
+                    const double centerX = (xs[x] + xs[x + 1]) * 0.5;
+                    const double centerY = (ys[y] + ys[y + 1]) * 0.5;
+                    const bool bCovered = std::any_of(polygons.begin(), polygons.end(),
+                                                      [centerX, centerY](const std::vector<Vector3>& rectangle)
+                                                      {
+                                                          return centerX > rectangle[0].X && centerX < rectangle[2].X &&
+                                                              centerY > rectangle[0].Y && centerY < rectangle[2].Y;
+                                                      });
+                    if (bCovered)
+                        area += (xs[x + 1] - xs[x]) * (ys[y + 1] - ys[y]);
+                }
+            }
+
+            SplineAreaGeometry::UnionPolygons(polygons, std::vector<std::vector<int>>(), pieces);
+            if (!ValidateUnionPieces(log, Format("seed %u union case %d (%d rectangles)", seed, caseIndex, rectangleCount),
+                                     pieces, area))
+                failureCount++;
+        }
+        log.Info(Format("SplineArea union test validated %d fixed and %d random sets of polygons",
+                        static_cast<int>(sizeof(unionCases) / sizeof(unionCases[0])), caseCount));
+        return failureCount;
+    }
+
+    int RunIncrementalEditTest(const CorpusLog& log, const uint32_t seed, const int caseCount)
+    {
+        const int editCount = 20;
+
+        int failureCount = 0;
+        int localUpdateCount = 0;
+        int totalEditCount = 0;
+
+        //Outlines the local updates used to give up on, a clockwise pentagon and a square with a point halfway its bottom
+        std::vector<Vector3> clockwisePentagon = Reversed(MakeConvexPolygon(5));
+        std::vector<Vector3> collinearSquare = {
+            {0.f, 0.f, 0.f}, {50.f, 0.f, 0.f}, {100.f, 0.f, 0.f}, {100.f, 100.f, 0.f}, {0.f, 100.f, 0.f}
+        };
+        struct FixedEdit
+        {
+            const char* Name;
+            std::vector<Vector3>* Points;
+            int PointIndex;
+        };
+        const FixedEdit fixedEdits[] = {
+            {"clockwise outline", &clockwisePentagon, 2},
+            {"collinear outline", &collinearSquare, 3},
+        };
+        for (const FixedEdit& fixedEdit : fixedEdits)
+        {
+            std::vector<Vector3>& points = *fixedEdit.Points;
+            std::vector<int> indices;
+            SplineAreaGeometry::TriangulatePolygon(points, indices);
+            SplineAreaGeometry::PointTriangleAdjacency adjacency;
+            adjacency.Build(static_cast<int>(points.size()), indices);
+
+            points[fixedEdit.PointIndex].X *= 1.1f;
+            std::string error;
+            if (!SplineAreaGeometry::RetriangulateMovedPoint(points, fixedEdit.PointIndex, indices, adjacency))
+            {
+                log.Error(Format("edit of a %s: the local update gave up", fixedEdit.Name));
+                failureCount++;
+            }
+            else if (!ValidateEdit(points, indices, adjacency, error))
+            {
+                log.Error(Format("edit of a %s: %s", fixedEdit.Name, error.c_str()));
+                failureCount++;
+            }
+        }
+
+        RandomStream randomStream(seed);
+        for (int caseIndex = 0; caseIndex < caseCount; caseIndex++)
+        {
+            std::vector<Vector3> points = MakeRandomStarPolygon(randomStream, randomStream.RandRange(5, 35));
+            if (caseIndex % 3 == 1)
+                std::reverse(points.begin(), points.end());
+            if (caseIndex % 4 == 2)
+                AddCollinearRuns(randomStream, points);
+
+            std::vector<int> indices;
+            SplineAreaGeometry::TriangulationStats stats;
+            SplineAreaGeometry::TriangulatePolygon(points, indices, &stats);
+            SplineAreaGeometry::PointTriangleAdjacency adjacency;
+            adjacency.Build(static_cast<int>(points.size()), indices);
+
+            for (int edit = 0; edit < editCount; edit++)
+            {
+                const int pointCount = static_cast<int>(points.size());
+                const int pointIndex = randomStream.RandRange(0, pointCount - 1);
+                const int editKind = randomStream.RandRange(0, 2);
+                std::vector<Vector3> editedPoints = points;
+                const std::vector<int> previousIndices = indices;
+                bool bLocalUpdate = false;
+                if (editKind == 0)
+                {
+                    editedPoints[pointIndex].X *= randomStream.FRandRange(0.9f, 1.1f);
+                    editedPoints[pointIndex].Y *= randomStream.FRandRange(0.9f, 1.1f);
+                    bLocalUpdate = !stats.bSelfIntersecting &&
+                        SplineAreaGeometry::RetriangulateMovedPoint(editedPoints, pointIndex, indices, adjacency);
+                }
+                else if (editKind == 1)
+                {
+                    //Half of the new points stay on the edge, the other half bend it outwards
+                    const Vector3& start = points[pointIndex];
+                    const Vector3& end = points[(pointIndex + 1) % pointCount];
+                    const float alpha = randomStream.FRandRange(0.2f, 0.8f);
+                    const float scale = randomStream.RandRange(0, 1) == 0 ? 1.f : 1.02f;
+                    const Vector3 newPoint = {(start.X + (end.X - start.X) * alpha) * scale,
+                                              (start.Y + (end.Y - start.Y) * alpha) * scale, 0.f};
+                    editedPoints.insert(editedPoints.begin() + pointIndex + 1, newPoint);
+                    bLocalUpdate = !stats.bSelfIntersecting &&
+                        SplineAreaGeometry::RetriangulateInsertedPoint(editedPoints, pointIndex + 1, indices, adjacency);
+                }
+                else
+                {
+                    if (pointCount < 5)
+                        continue;
+                    editedPoints.erase(editedPoints.begin() + pointIndex);
+                    bLocalUpdate = !stats.bSelfIntersecting &&
+                        SplineAreaGeometry::RetriangulateRemovedPoint(editedPoints, pointIndex, indices, adjacency);
+                }
+                totalEditCount++;
+
+                const std::string caseName = Format("seed %u edit case %d edit %d", seed, caseIndex, edit);
+                std::string error;
+                if (bLocalUpdate)
+                {
+                    localUpdateCount++;
+                    if (!ValidateEdit(editedPoints, indices, adjacency, error))
+                    {
+                        log.Error(caseName + ": " + error);
+                        failureCount++;
+                        break;
+                    }
+                }
+                else if (indices != previousIndices || adjacency.GetPointCount() != pointCount)
+                {
+                    log.Error(caseName + ": the local update gave up but changed the triangulation");
+                    failureCount++;
+                    break;
+                }
+                else
+                {
+                    //What the area does when a local update does not apply
+                    indices.clear();
+                    SplineAreaGeometry::TriangulatePolygon(editedPoints, indices, &stats);
+                    adjacency.Build(static_cast<int>(editedPoints.size()), indices);
+                }
+                points.swap(editedPoints);
+            }
+        }
+        log.Info(Format("SplineArea incremental edit test applied %d of %d random edits locally", localUpdateCount,
+                        totalEditCount));
+        return failureCount;
+    }
+}
+
+#endif
@@ -0,0 +1,165 @@
+// Copyright 2021 Robin Smekens
+
+#pragma once
+
+#include "SplineAreaGeometry.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// Polygon corpus and checks of the triangulation. Plain C++ like the geometry itself, so the SplineArea.Benchmark console
+/// command and the SplineArea.Geometry automation tests in the editor and the standalone benchmark executable run the same
+/// polygons through the same checks
+/// </summary>
+namespace SplineAreaGeometryCorpus
+{
+    using SplineAreaGeometry::Vector3;
+
+    /// <summary>
+    /// Seeded random numbers, the same seed gives the same polygons on every platform
+    /// </summary>
+    class RandomStream
+    {
+    public:
+        explicit RandomStream(uint32_t seed);
+
+        /// <summary>
+        /// Random float from min up to max
+        /// </summary>
+        float FRandRange(float min, float max);
+
+        /// <summary>
+        /// Random int from min up to and including max
+        /// </summary>
+        int RandRange(int min, int max);
+
+    private:
+        uint32_t Seed;
+    };
+
+    /// <summary>
+    /// Receives the messages of a run, the editor sends them to the log and the executable to the console
+    /// </summary>
+    struct CorpusLog
+    {
+        std::function<void(const std::string&)> Info;
+        std::function<void(const std::string&)> Error;
+    };
+
+    /// <summary>
+    /// printf style formatting into a string for the log
+    /// </summary>
+    std::string Format(const char* format, ...);
+
+    /// <summary>
+    /// Regular polygon, every point is an ear
+    /// </summary>
+    std::vector<Vector3> MakeConvexPolygon(int pointCount);
+
+    /// <summary>
+    /// Star with alternating inner and outer radius, half of the points are reflex
+    /// </summary>
+    std::vector<Vector3> MakeStarPolygon(int pointCount);
+
+    /// <summary>
+    /// Thin band winding outwards, the inner side of the band is entirely reflex
+    /// </summary>
+    std::vector<Vector3> MakeSpiralPolygon(int pointCount);
+
+    /// <summary>
+    /// Strip with narrow teeth on top, every gap between two teeth holds two reflex points
+    /// </summary>
+    std::vector<Vector3> MakeCombPolygon(int pointCount);
+
+    /// <summary>
+    /// Noisy star shaped outline, roughly half of the points are reflex and spread over the whole area
+    /// </summary>
+    std::vector<Vector3> MakeCoastlinePolygon(int pointCount);
+
+    /// <summary>
+    /// Comb whose teeth are only a hundredth of a unit apart, the edges of neighbouring teeth nearly touch
+    /// </summary>
+    std::vector<Vector3> MakeNearTouchingCombPolygon(int pointCount);
+
+    /// <summary>
+    /// Random star shaped polygon, the points are sorted by angle around the center so the outline never crosses itself
+    /// </summary>
+    std::vector<Vector3> MakeRandomStarPolygon(RandomStream& randomStream, int pointCount);
+
+    /// <summary>
+    /// Random polygon that is monotone in x, a jagged lower chain below the x axis and a jagged upper chain above it
+    /// </summary>
+    std::vector<Vector3> MakeRandomMonotonePolygon(RandomStream& randomStream, int pointCount);
+
+    /// <summary>
+    /// Repeats random points of the polygon one or more times in place
+    /// </summary>
+    void AddDuplicatePoints(RandomStream& randomStream, std::vector<Vector3>& points);
+
+    /// <summary>
+    /// Splits random edges of the polygon into runs of points that lie on the edge
+    /// </summary>
+    void AddCollinearRuns(RandomStream& randomStream, std::vector<Vector3>& points);
+
+    /// <summary>
+    /// Checks the triangulation of the polygon and writes the first problem to outError when it is not valid.
+    /// Every loop gets cleaned like the triangulation does, the outline plus its bridged holes have to give the matching
+    /// number of triangles that all wind opposite to the outline and cover the outline minus the holes. The triangle edges
+    /// also have to cancel out against the loops: interior edges and bridges get walked once in both directions and every
+    /// loop edge once. With one winding for every triangle that leaves every point inside covered exactly once, so the
+    /// triangles can not overlap
+    /// </summary>
+    /// <param name="points"> The outline followed by its holes like in TriangulatePolygonWithHoles </param>
+    /// <param name="holeStarts"> Index of the first point of every hole, all of them have to lie inside of the outline </param>
+    /// <param name="indices"> Triangulation of the points </param>
+    bool ValidateTriangulation(const std::vector<Vector3>& points, const std::vector<int>& holeStarts,
+                               const std::vector<int>& indices, std::string& outError);
+
+    /// <summary>
+    /// Slope of the least squares line through the timings on a log-log scale, 1 is linear and 2 quadratic
+    /// </summary>
+    double FitScalingExponent(const std::vector<int>& pointCounts, const std::vector<double>& seconds);
+
+    /// <summary>
+    /// Triangulates the convex, star, spiral, comb and coastline corpus and logs the time per stage, triangles per second, the
+    /// allocations of the first and the later runs and how the time scales with the point count. Every result gets validated,
+    /// returns the number of invalid results
+    /// </summary>
+    int RunBenchmark(const CorpusLog& log);
+
+    /// <summary>
+    /// Validates the triangulation of random simple polygons and of variants with duplicate points, collinear runs and
+    /// clockwise winding. A clockwise polygon has to give the same triangles as its counter clockwise original. Every polygon
+    /// comes from the seed, so a failing case can be run again. Returns the number of failed checks
+    /// </summary>
+    int RunStressTest(const CorpusLog& log, uint32_t seed, int caseCount);
+
+    /// <summary>
+    /// Triangulates comb, spiral, near touching comb and coastline polygons up to 50k points and fails every shape whose time
+    /// grows faster than O(n^2.5) with the point count. Returns the number of failed checks
+    /// </summary>
+    int RunScalingTest(const CorpusLog& log);
+
+    /// <summary>
+    /// Validates outlines with holes: fixed holes inside, left and right of, overlapping and in a notch of the outline, then
+    /// random outlines with up to 16 random holes. Holes that are not inside of the outline have to be left out. Returns the
+    /// number of failed checks
+    /// </summary>
+    int RunHoleTest(const CorpusLog& log, uint32_t seed, int caseCount);
+
+    /// <summary>
+    /// Merges fixed sets of overlapping, disjoint, framing and stacked squares and random sets of rectangles, then checks the
+    /// piece and hole counts and that the triangulated pieces cover the area of the union. Returns the number of failed checks
+    /// </summary>
+    int RunUnionTest(const CorpusLog& log, uint32_t seed, int caseCount);
+
+    /// <summary>
+    /// Moves, inserts and removes random points of random polygons through the local updates. A successful update has to give
+    /// a valid triangulation with a matching adjacency, a failed one has to leave both untouched. Clockwise outlines and
+    /// outlines with collinear points have to take the local update. Returns the number of failed checks
+    /// </summary>
+    int RunIncrementalEditTest(const CorpusLog& log, uint32_t seed, int caseCount);
+}
@@ -0,0 +1,233 @@
+// Copyright 2021 Robin Smekens
+
+#include "SplineAreaGeometry.h"
+
+#include <algorithm>
+#include <cmath>
+
+//Both are always defined, modules get built with undefined identifiers in #if as errors
+#if defined(__AVX__)
+#include <immintrin.h>
+#define SPLINEAREA_KERNELS_AVX 1
+#define SPLINEAREA_KERNELS_SSE 0
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SPLINEAREA_KERNELS_AVX 0
+#define SPLINEAREA_KERNELS_SSE 1
+#else
+#define SPLINEAREA_KERNELS_AVX 0
+#define SPLINEAREA_KERNELS_SSE 0
+#endif
+
+namespace SplineAreaGeometry
+{
+    namespace
+    {
+        //Relative error of a float orientation: Shewchuk's ccwerrboundA for floats with some headroom for the bound itself.
+        //Lanes closer to zero than this times the magnitude of their products get decided by the exact predicate
+        constexpr float OrientationErrorFactor = 4.e-7f;
+        //Same for the edge tests of a point against a triangle, where the edge vectors get rounded once more
+        constexpr float EdgeErrorFactor = 8.e-7f;
+
+        inline bool IsInTriangleExact(const float x, const float y, const Vector3& a, const Vector3& b, const Vector3& c)
+        {
+            //NaN coordinates belong to points that got removed
+            if (x != x || y != y)
+                return false;
+            if ((x == a.X && y == a.Y) || (x == b.X && y == b.Y) || (x == c.X && y == c.Y))
+                return false;
+
+            const Vector3 point = {x, y, 0.f};
+            return OrientationSign(a, b, point) >= 0 && OrientationSign(b, c, point) >= 0 && OrientationSign(c, a, point) >= 0;
+        }
+
+        inline bool IsConvexExact(const float prevX, const float prevY, const float curX, const float curY, const float nextX,
+                                  const float nextY)
+        {
+            return PointIsConvex({prevX, prevY, 0.f}, {curX, curY, 0.f}, {nextX, nextY, 0.f});
+        }
+    }
+
+    void ClassifyConvexBatch(const float* xs, const float* ys, const int count, unsigned char* outConvex)
+    {
+        int i = 0;
+#if SPLINEAREA_KERNELS_AVX
+        const __m256 signMask = _mm256_set1_ps(-0.f);
+        const __m256 errorFactor = _mm256_set1_ps(OrientationErrorFactor);
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256 prevX = _mm256_loadu_ps(xs + i);
+            const __m256 prevY = _mm256_loadu_ps(ys + i);
+            const __m256 curX = _mm256_loadu_ps(xs + i + 1);
+            const __m256 curY = _mm256_loadu_ps(ys + i + 1);
+            const __m256 nextX = _mm256_loadu_ps(xs + i + 2);
+            const __m256 nextY = _mm256_loadu_ps(ys + i + 2);
+
+            const __m256 left = _mm256_mul_ps(_mm256_sub_ps(curX, prevX), _mm256_sub_ps(nextY, prevY));
+            const __m256 right = _mm256_mul_ps(_mm256_sub_ps(curY, prevY), _mm256_sub_ps(nextX, prevX));
+            const __m256 cross = _mm256_sub_ps(left, right);
+            const __m256 bound = _mm256_mul_ps(errorFactor, _mm256_add_ps(_mm256_andnot_ps(signMask, left),
+                                                                          _mm256_andnot_ps(signMask, right)));
+            const int mask = _mm256_movemask_ps(_mm256_cmp_ps(cross, bound, _CMP_GT_OQ));
+            const int uncertainMask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_andnot_ps(signMask, cross), bound, _CMP_LE_OQ));
+            for (int lane = 0; lane < 8; lane++)
+            {
+                const int point = i + lane;
+                outConvex[point] = (uncertainMask >> lane) & 1
+                                       ? IsConvexExact(xs[point], ys[point], xs[point + 1], ys[point + 1], xs[point + 2], ys[point + 2])
+                                       : static_cast<unsigned char>((mask >> lane) & 1);
+            }
+        }
+#elif SPLINEAREA_KERNELS_SSE
+        const __m128 signMask = _mm_set1_ps(-0.f);
+        const __m128 errorFactor = _mm_set1_ps(OrientationErrorFactor);
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 prevX = _mm_loadu_ps(xs + i);
+            const __m128 prevY = _mm_loadu_ps(ys + i);
+            const __m128 curX = _mm_loadu_ps(xs + i + 1);
+            const __m128 curY = _mm_loadu_ps(ys + i + 1);
+            const __m128 nextX = _mm_loadu_ps(xs + i + 2);
+            const __m128 nextY = _mm_loadu_ps(ys + i + 2);
+
+            const __m128 left = _mm_mul_ps(_mm_sub_ps(curX, prevX), _mm_sub_ps(nextY, prevY));
+            const __m128 right = _mm_mul_ps(_mm_sub_ps(curY, prevY), _mm_sub_ps(nextX, prevX));
+            const __m128 cross = _mm_sub_ps(left, right);
+            const __m128 bound = _mm_mul_ps(errorFactor, _mm_add_ps(_mm_andnot_ps(signMask, left), _mm_andnot_ps(signMask, right)));
+            const int mask = _mm_movemask_ps(_mm_cmpgt_ps(cross, bound));
+            const int uncertainMask = _mm_movemask_ps(_mm_cmple_ps(_mm_andnot_ps(signMask, cross), bound));
+            for (int lane = 0; lane < 4; lane++)
+            {
+                const int point = i + lane;
+                outConvex[point] = (uncertainMask >> lane) & 1
+                                       ? IsConvexExact(xs[point], ys[point], xs[point + 1], ys[point + 1], xs[point + 2], ys[point + 2])
+                                       : static_cast<unsigned char>((mask >> lane) & 1);
+            }
+        }
+#endif
+        for (; i < count; i++)
+        {
+            outConvex[i] = IsConvexExact(xs[i], ys[i], xs[i + 1], ys[i + 1], xs[i + 2], ys[i + 2]) ? 1 : 0;
+        }
+    }
+
+    bool AnyPointInTriangleBatch(const float* xs, const float* ys, const int count, const Vector3& a, const Vector3& b,
+                                 const Vector3& c)
+    {
+        //Points outside of the bounding box are outside of the triangle, inside of it the products of the edge tests are
+        //bounded by the size of the box so one error bound per edge covers every point
+        const float minX = std::min(std::min(a.X, b.X), c.X);
+        const float minY = std::min(std::min(a.Y, b.Y), c.Y);
+        const float maxX = std::max(std::max(a.X, b.X), c.X);
+        const float maxY = std::max(std::max(a.Y, b.Y), c.Y);
+        const float extent = std::max(maxX - minX, maxY - minY);
+        const float boundAB = -EdgeErrorFactor * extent * (std::abs(b.X - a.X) + std::abs(b.Y - a.Y));
+        const float boundBC = -EdgeErrorFactor * extent * (std::abs(c.X - b.X) + std::abs(c.Y - b.Y));
+        const float boundCA = -EdgeErrorFactor * extent * (std::abs(a.X - c.X) + std::abs(a.Y - c.Y));
+
+        int i = 0;
+#if SPLINEAREA_KERNELS_AVX
+        {
+            const __m256 aX = _mm256_set1_ps(a.X);
+            const __m256 aY = _mm256_set1_ps(a.Y);
+            const __m256 bX = _mm256_set1_ps(b.X);
+            const __m256 bY = _mm256_set1_ps(b.Y);
+            const __m256 cX = _mm256_set1_ps(c.X);
+            const __m256 cY = _mm256_set1_ps(c.Y);
+            const __m256 abX = _mm256_set1_ps(b.X - a.X);
+            const __m256 abY = _mm256_set1_ps(b.Y - a.Y);
+            const __m256 bcX = _mm256_set1_ps(c.X - b.X);
+            const __m256 bcY = _mm256_set1_ps(c.Y - b.Y);
+            const __m256 caX = _mm256_set1_ps(a.X - c.X);
+            const __m256 caY = _mm256_set1_ps(a.Y - c.Y);
+            const __m256 lowX = _mm256_set1_ps(minX);
+            const __m256 lowY = _mm256_set1_ps(minY);
+            const __m256 highX = _mm256_set1_ps(maxX);
+            const __m256 highY = _mm256_set1_ps(maxY);
+            const __m256 errorAB = _mm256_set1_ps(boundAB);
+            const __m256 errorBC = _mm256_set1_ps(boundBC);
+            const __m256 errorCA = _mm256_set1_ps(boundCA);
+
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256 x = _mm256_loadu_ps(xs + i);
+                const __m256 y = _mm256_loadu_ps(ys + i);
+
+                const __m256 edgeAB = _mm256_sub_ps(_mm256_mul_ps(abX, _mm256_sub_ps(y, aY)), _mm256_mul_ps(abY, _mm256_sub_ps(x, aX)));
+                const __m256 edgeBC = _mm256_sub_ps(_mm256_mul_ps(bcX, _mm256_sub_ps(y, bY)), _mm256_mul_ps(bcY, _mm256_sub_ps(x, bX)));
+                const __m256 edgeCA = _mm256_sub_ps(_mm256_mul_ps(caX, _mm256_sub_ps(y, cY)), _mm256_mul_ps(caY, _mm256_sub_ps(x, cX)));
+
+                //Ordered comparisons are false for NaN, so removed points drop out here
+                __m256 candidate = _mm256_and_ps(_mm256_cmp_ps(x, lowX, _CMP_GE_OQ), _mm256_cmp_ps(x, highX, _CMP_LE_OQ));
+                candidate = _mm256_and_ps(candidate, _mm256_and_ps(_mm256_cmp_ps(y, lowY, _CMP_GE_OQ), _mm256_cmp_ps(y, highY, _CMP_LE_OQ)));
+                candidate = _mm256_and_ps(candidate, _mm256_and_ps(_mm256_cmp_ps(edgeAB, errorAB, _CMP_GE_OQ),
+                                                                   _mm256_cmp_ps(edgeBC, errorBC, _CMP_GE_OQ)));
+                candidate = _mm256_and_ps(candidate, _mm256_cmp_ps(edgeCA, errorCA, _CMP_GE_OQ));
+
+                //Points that might be inside get confirmed exactly, most batches have none
+                int mask = _mm256_movemask_ps(candidate);
+                for (int lane = 0; mask != 0; lane++, mask >>= 1)
+                {
+                    if ((mask & 1) && IsInTriangleExact(xs[i + lane], ys[i + lane], a, b, c))
+                        return true;
+                }
+            }
+        }
+#elif SPLINEAREA_KERNELS_SSE
+        {
+            const __m128 aX = _mm_set1_ps(a.X);
+            const __m128 aY = _mm_set1_ps(a.Y);
+            const __m128 bX = _mm_set1_ps(b.X);
+            const __m128 bY = _mm_set1_ps(b.Y);
+            const __m128 cX = _mm_set1_ps(c.X);
+            const __m128 cY = _mm_set1_ps(c.Y);
+            const __m128 abX = _mm_set1_ps(b.X - a.X);
+            const __m128 abY = _mm_set1_ps(b.Y - a.Y);
+            const __m128 bcX = _mm_set1_ps(c.X - b.X);
+            const __m128 bcY = _mm_set1_ps(c.Y - b.Y);
+            const __m128 caX = _mm_set1_ps(a.X - c.X);
+            const __m128 caY = _mm_set1_ps(a.Y - c.Y);
+            const __m128 lowX = _mm_set1_ps(minX);
+            const __m128 lowY = _mm_set1_ps(minY);
+            const __m128 highX = _mm_set1_ps(maxX);
+            const __m128 highY = _mm_set1_ps(maxY);
+            const __m128 errorAB = _mm_set1_ps(boundAB);
+            const __m128 errorBC = _mm_set1_ps(boundBC);
+            const __m128 errorCA = _mm_set1_ps(boundCA);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 x = _mm_loadu_ps(xs + i);
+                const __m128 y = _mm_loadu_ps(ys + i);
+
+                const __m128 edgeAB = _mm_sub_ps(_mm_mul_ps(abX, _mm_sub_ps(y, aY)), _mm_mul_ps(abY, _mm_sub_ps(x, aX)));
+                const __m128 edgeBC = _mm_sub_ps(_mm_mul_ps(bcX, _mm_sub_ps(y, bY)), _mm_mul_ps(bcY, _mm_sub_ps(x, bX)));
+                const __m128 edgeCA = _mm_sub_ps(_mm_mul_ps(caX, _mm_sub_ps(y, cY)), _mm_mul_ps(caY, _mm_sub_ps(x, cX)));
+
+                //Ordered comparisons are false for NaN, so removed points drop out here
+                __m128 candidate = _mm_and_ps(_mm_cmpge_ps(x, lowX), _mm_cmple_ps(x, highX));
+                candidate = _mm_and_ps(candidate, _mm_and_ps(_mm_cmpge_ps(y, lowY), _mm_cmple_ps(y, highY)));
+                candidate = _mm_and_ps(candidate, _mm_and_ps(_mm_cmpge_ps(edgeAB, errorAB), _mm_cmpge_ps(edgeBC, errorBC)));
+                candidate = _mm_and_ps(candidate, _mm_cmpge_ps(edgeCA, errorCA));
+
+                //Points that might be inside get confirmed exactly, most batches have none
+                int mask = _mm_movemask_ps(candidate);
+                for (int lane = 0; mask != 0; lane++, mask >>= 1)
+                {
+                    if ((mask & 1) && IsInTriangleExact(xs[i + lane], ys[i + lane], a, b, c))
+                        return true;
+                }
+            }
+        }
+#endif
+        for (; i < count; i++)
+        {
+            if (xs[i] >= minX && xs[i] <= maxX && ys[i] >= minY && ys[i] <= maxY && IsInTriangleExact(xs[i], ys[i], a, b, c))
+                return true;
+        }
+        return false;
+    }
+}
+
+#undef SPLINEAREA_KERNELS_AVX
+#undef SPLINEAREA_KERNELS_SSE
@@ -0,0 +1,87 @@
+// Copyright 2021 Robin Smekens
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "SplineAreaGeometryCorpus.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+    using namespace SplineAreaGeometryCorpus;
+
+    /// <summary>
+    /// Runs one suite of the polygon corpus, every failed check becomes an error of the automation test. The standalone
+    /// benchmark executable runs the same suites
+    /// </summary>
+    bool RunCorpusSuite(FAutomationTestBase& test, const TFunctionRef<int(const CorpusLog&)> suite)
+    {
+        CorpusLog log;
+        log.Info = [&test](const std::string& message)
+        {
+            test.AddInfo(UTF8_TO_TCHAR(message.c_str()));
+        };
+        log.Error = [&test](const std::string& message)
+        {
+            test.AddError(UTF8_TO_TCHAR(message.c_str()));
+        };
+        return suite(log) == 0;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSplineAreaStressTest, "SplineArea.Geometry.Stress",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSplineAreaStressTest::RunTest(const FString& Parameters)
+{
+    return RunCorpusSuite(*this, [](const CorpusLog& log)
+    {
+        return RunStressTest(log, 1, 500);
+    });
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSplineAreaScalingTest, "SplineArea.Geometry.Scaling",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FSplineAreaScalingTest::RunTest(const FString& Parameters)
+{
+    return RunCorpusSuite(*this, [](const CorpusLog& log)
+    {
+        return RunScalingTest(log);
+    });
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSplineAreaHoleTest, "SplineArea.Geometry.Holes",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSplineAreaHoleTest::RunTest(const FString& Parameters)
+{
+    return RunCorpusSuite(*this, [](const CorpusLog& log)
+    {
+        return RunHoleTest(log, 1, 200);
+    });
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSplineAreaUnionTest, "SplineArea.Geometry.Union",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSplineAreaUnionTest::RunTest(const FString& Parameters)
+{
+    return RunCorpusSuite(*this, [](const CorpusLog& log)
+    {
+        return RunUnionTest(log, 1, 200);
+    });
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSplineAreaIncrementalEditTest, "SplineArea.Geometry.IncrementalEdits",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSplineAreaIncrementalEditTest::RunTest(const FString& Parameters)
+{
+    return RunCorpusSuite(*this, [](const CorpusLog& log)
+    {
+        return RunIncrementalEditTest(log, 1, 500);
+    });
+}
+
+#endif
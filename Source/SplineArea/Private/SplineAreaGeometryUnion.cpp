@@ -0,0 +1,722 @@
+// Copyright 2021 Robin Smekens
+
+#include "SplineAreaGeometry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+namespace SplineAreaGeometry
+{
+    namespace
+    {
+        struct BoundingBox
+        {
+            float MinX = 0.f;
+            float MinY = 0.f;
+            float MinZ = 0.f;
+            float MaxX = 0.f;
+            float MaxY = 0.f;
+            float MaxZ = 0.f;
+        };
+
+        /// <summary>
+        /// Cleaned loops of one input polygon, its counter clockwise outline first and then its clockwise holes
+        /// </summary>
+        struct UnionPolygon
+        {
+            std::vector<Vector3> Points;
+            //Next point of the loop every point belongs to
+            std::vector<int> NextPoints;
+            //Loop i holds the points from LoopStarts[i] up to LoopStarts[i + 1], loop 0 is the outline
+            std::vector<int> LoopStarts;
+        };
+
+        struct UnionEdge
+        {
+            int Polygon = 0;
+            int Index = 0;
+            float MinX = 0.f;
+            float MaxX = 0.f;
+            float MinY = 0.f;
+            float MaxY = 0.f;
+        };
+
+        /// <summary>
+        /// Point an edge has to be split at, T is the position along the edge from 0 at its start to 1 at its end
+        /// </summary>
+        struct EdgeSplit
+        {
+            int Edge = 0;
+            double T = 0.0;
+            Vector3 Point = Vector3();
+        };
+
+        struct UnionSubEdge
+        {
+            int From = 0;
+            int To = 0;
+            int Polygon = 0;
+            //Next sub-edge with the same start and end vertex
+            int NextSame = -1;
+            bool bKept = false;
+        };
+
+        BoundingBox GetBoundingBox(const std::vector<Vector3>& points)
+        {
+            BoundingBox box;
+            box.MinX = box.MaxX = points[0].X;
+            box.MinY = box.MaxY = points[0].Y;
+            box.MinZ = box.MaxZ = points[0].Z;
+            for (const Vector3& point : points)
+            {
+                box.MinX = std::min(box.MinX, point.X);
+                box.MinY = std::min(box.MinY, point.Y);
+                box.MinZ = std::min(box.MinZ, point.Z);
+                box.MaxX = std::max(box.MaxX, point.X);
+                box.MaxY = std::max(box.MaxY, point.Y);
+                box.MaxZ = std::max(box.MaxZ, point.Z);
+            }
+            return box;
+        }
+
+        bool BoxesOverlap(const BoundingBox& a, const BoundingBox& b)
+        {
+            return a.MinX <= b.MaxX && b.MinX <= a.MaxX && a.MinY <= b.MaxY && b.MinY <= a.MaxY && a.MinZ <= b.MaxZ &&
+                b.MinZ <= a.MaxZ;
+        }
+
+        int FindRoot(std::vector<int>& parents, int index)
+        {
+            while (parents[index] != index)
+            {
+                parents[index] = parents[parents[index]];
+                index = parents[index];
+            }
+            return index;
+        }
+
+        /// <summary>
+        /// Crossing number test on the XY plane, points on the outline can land on either side
+        /// </summary>
+        bool IsPointInRing(const std::vector<Vector3>& ring, const double x, const double y)
+        {
+            bool bInside = false;
+            const int pointCount = static_cast<int>(ring.size());
+            for (int i = 0, j = pointCount - 1; i < pointCount; j = i++)
+            {
+                const Vector3& a = ring[i];
+                const Vector3& b = ring[j];
+                if ((a.Y > y) == (b.Y > y))
+                    continue;
+
+                const double crossX = b.X + (y - b.Y) * (static_cast<double>(a.X) - b.X) / (static_cast<double>(a.Y) - b.Y);
+                if (x < crossX)
+                    bInside = !bInside;
+            }
+            return bInside;
+        }
+
+        /// <summary>
+        /// Edges of a polygon sorted into horizontal rows, a crossing number test then only looks at the edges of one row
+        /// </summary>
+        struct RingRowIndex
+        {
+            const UnionPolygon* Polygon = nullptr;
+            float MinY = 0.f;
+            float InvRowHeight = 1.f;
+            int RowCount = 1;
+
+            //Row i owns the edges from RowStarts[i] up to RowStarts[i + 1]
+            std::vector<int> RowStarts;
+            std::vector<int> RowEdges;
+
+            void Build(const UnionPolygon& polygon, const BoundingBox& box)
+            {
+                Polygon = &polygon;
+                const int pointCount = static_cast<int>(polygon.Points.size());
+                MinY = box.MinY;
+                RowCount = std::max(1, std::min(pointCount, 4096));
+                InvRowHeight = box.MaxY > box.MinY ? RowCount / (box.MaxY - box.MinY) : 0.f;
+
+                RowStarts.assign(RowCount + 1, 0);
+                for (int i = 0; i < pointCount; i++)
+                {
+                    int firstRow;
+                    int lastRow;
+                    GetEdgeRows(i, firstRow, lastRow);
+                    for (int row = firstRow; row <= lastRow; row++)
+                    {
+                        RowStarts[row + 1]++;
+                    }
+                }
+                for (int row = 0; row < RowCount; row++)
+                {
+                    RowStarts[row + 1] += RowStarts[row];
+                }
+
+                RowEdges.resize(RowStarts[RowCount]);
+                std::vector<int> rowFill(RowStarts.begin(), RowStarts.end() - 1);
+                for (int i = 0; i < pointCount; i++)
+                {
+                    int firstRow;
+                    int lastRow;
+                    GetEdgeRows(i, firstRow, lastRow);
+                    for (int row = firstRow; row <= lastRow; row++)
+                    {
+                        RowEdges[rowFill[row]++] = i;
+                    }
+                }
+            }
+
+            /// <summary>
+            /// Crossing number test on the XY plane over the edges of all loops, so points in a hole are outside. Points on the
+            /// outline can land on either side
+            /// </summary>
+            bool Contains(const double x, const double y) const
+            {
+                const std::vector<Vector3>& points = Polygon->Points;
+                const int row = Row(static_cast<float>(y));
+                bool bInside = false;
+                for (int item = RowStarts[row]; item < RowStarts[row + 1]; item++)
+                {
+                    const Vector3& a = points[RowEdges[item]];
+                    const Vector3& b = points[Polygon->NextPoints[RowEdges[item]]];
+                    if ((a.Y > y) == (b.Y > y))
+                        continue;
+
+                    const double crossX = b.X + (y - b.Y) * (static_cast<double>(a.X) - b.X) / (static_cast<double>(a.Y) - b.Y);
+                    if (x < crossX)
+                        bInside = !bInside;
+                }
+                return bInside;
+            }
+
+        private:
+            int Row(const float y) const
+            {
+                return std::max(0, std::min(RowCount - 1, static_cast<int>((y - MinY) * InvRowHeight)));
+            }
+
+            void GetEdgeRows(const int edge, int& outFirstRow, int& outLastRow) const
+            {
+                const float y1 = Polygon->Points[edge].Y;
+                const float y2 = Polygon->Points[Polygon->NextPoints[edge]].Y;
+                outFirstRow = Row(std::min(y1, y2));
+                outLastRow = Row(std::max(y1, y2));
+            }
+        };
+
+        /// <summary>
+        /// Checks if p lies strictly between a and b, p is expected to be collinear with them
+        /// </summary>
+        bool IsBetween(const Vector3& a, const Vector3& b, const Vector3& p)
+        {
+            return (static_cast<double>(p.X) - a.X) * (static_cast<double>(p.X) - b.X) +
+                (static_cast<double>(p.Y) - a.Y) * (static_cast<double>(p.Y) - b.Y) < 0.0;
+        }
+
+        double EdgeParameter(const Vector3& a, const Vector3& b, const Vector3& p)
+        {
+            const double edgeX = static_cast<double>(b.X) - a.X;
+            const double edgeY = static_cast<double>(b.Y) - a.Y;
+            return ((p.X - a.X) * edgeX + (p.Y - a.Y) * edgeY) / (edgeX * edgeX + edgeY * edgeY);
+        }
+
+        uint64_t PositionKey(const Vector3& point)
+        {
+            //Adding zero turns -0 into 0, so both weld
+            const float x = point.X + 0.f;
+            const float y = point.Y + 0.f;
+            uint32_t xBits;
+            uint32_t yBits;
+            std::memcpy(&xBits, &x, sizeof(float));
+            std::memcpy(&yBits, &y, sizeof(float));
+            return static_cast<uint64_t>(xBits) << 32 | yBits;
+        }
+
+        uint64_t EdgeKey(const int from, const int to)
+        {
+            return static_cast<uint64_t>(static_cast<uint32_t>(from)) << 32 | static_cast<uint32_t>(to);
+        }
+
+        /// <summary>
+        /// Drops points that are collinear with their neighbours, these are left behind where an edge got split at a point that
+        /// ended up inside the union
+        /// </summary>
+        void RemoveCollinearPoints(std::vector<Vector3>& ring)
+        {
+            std::vector<Vector3> kept;
+            kept.reserve(ring.size());
+            for (const Vector3& point : ring)
+            {
+                while (kept.size() >= 2 && OrientationSign(kept[kept.size() - 2], kept.back(), point) == 0)
+                {
+                    kept.pop_back();
+                }
+                kept.push_back(point);
+            }
+
+            //The start of the ring was never checked against its end
+            size_t start = 0;
+            bool bRemoved = true;
+            while (bRemoved && kept.size() - start >= 3)
+            {
+                bRemoved = false;
+                if (OrientationSign(kept[kept.size() - 2], kept.back(), kept[start]) == 0)
+                {
+                    kept.pop_back();
+                    bRemoved = true;
+                }
+                else if (OrientationSign(kept.back(), kept[start], kept[start + 1]) == 0)
+                {
+                    start++;
+                    bRemoved = true;
+                }
+            }
+            ring.assign(kept.begin() + start, kept.end());
+        }
+
+        /// <summary>
+        /// Merges one group of polygons with overlapping bounding boxes, appends the outlines of the union to outRings
+        /// </summary>
+        void UnionGroup(const std::vector<UnionPolygon>& polygons, const std::vector<BoundingBox>& boxes,
+                        const std::vector<int>& group, std::vector<std::vector<Vector3>>& outRings)
+        {
+            const int polygonCount = static_cast<int>(group.size());
+
+            std::vector<RingRowIndex> rowIndices(polygonCount);
+            for (int p = 0; p < polygonCount; p++)
+            {
+                rowIndices[p].Build(polygons[group[p]], boxes[group[p]]);
+            }
+
+            //Sweep over the edges of all polygons by x, only edges of different polygons get tested against each other
+            std::vector<UnionEdge> edges;
+            for (int p = 0; p < polygonCount; p++)
+            {
+                const UnionPolygon& polygon = polygons[group[p]];
+                const int pointCount = static_cast<int>(polygon.Points.size());
+                for (int i = 0; i < pointCount; i++)
+                {
+                    const Vector3& a = polygon.Points[i];
+                    const Vector3& b = polygon.Points[polygon.NextPoints[i]];
+                    edges.push_back({p, i, std::min(a.X, b.X), std::max(a.X, b.X), std::min(a.Y, b.Y), std::max(a.Y, b.Y)});
+                }
+            }
+
+            std::vector<int> edgeOrder(edges.size());
+            for (int i = 0; i < static_cast<int>(edgeOrder.size()); i++)
+            {
+                edgeOrder[i] = i;
+            }
+            std::sort(edgeOrder.begin(), edgeOrder.end(), [&edges](const int a, const int b)
+            {
+                return edges[a].MinX < edges[b].MinX;
+            });
+
+            const auto edgeStart = [&](const UnionEdge& edge) -> const Vector3&
+            {
+                return polygons[group[edge.Polygon]].Points[edge.Index];
+            };
+            const auto edgeEnd = [&](const UnionEdge& edge) -> const Vector3&
+            {
+                const UnionPolygon& polygon = polygons[group[edge.Polygon]];
+                return polygon.Points[polygon.NextPoints[edge.Index]];
+            };
+
+            std::vector<EdgeSplit> splits;
+            std::vector<int> activeEdges;
+            for (const int edgeIndex : edgeOrder)
+            {
+                const UnionEdge& edge = edges[edgeIndex];
+                for (int i = static_cast<int>(activeEdges.size()) - 1; i >= 0; i--)
+                {
+                    if (edges[activeEdges[i]].MaxX < edge.MinX)
+                    {
+                        activeEdges[i] = activeEdges.back();
+                        activeEdges.pop_back();
+                    }
+                }
+
+                const Vector3& a = edgeStart(edge);
+                const Vector3& b = edgeEnd(edge);
+                for (const int otherIndex : activeEdges)
+                {
+                    const UnionEdge& other = edges[otherIndex];
+                    if (other.Polygon == edge.Polygon || other.MaxY < edge.MinY || edge.MaxY < other.MinY)
+                        continue;
+
+                    const Vector3& c = edgeStart(other);
+                    const Vector3& d = edgeEnd(other);
+                    const int o1 = OrientationSign(a, b, c);
+                    const int o2 = OrientationSign(a, b, d);
+                    const int o3 = OrientationSign(c, d, a);
+                    const int o4 = OrientationSign(c, d, b);
+
+                    if (o1 * o2 < 0 && o3 * o4 < 0)
+                    {
+                        //Both edges get split at the same rounded point, so the pieces share that vertex exactly
+                        const double edgeX = static_cast<double>(b.X) - a.X;
+                        const double edgeY = static_cast<double>(b.Y) - a.Y;
+                        const double otherX = static_cast<double>(d.X) - c.X;
+                        const double otherY = static_cast<double>(d.Y) - c.Y;
+                        const double t = ((c.X - a.X) * otherY - (c.Y - a.Y) * otherX) / (edgeX * otherY - edgeY * otherX);
+                        const Vector3 point = {
+                            static_cast<float>(a.X + t * edgeX), static_cast<float>(a.Y + t * edgeY),
+                            static_cast<float>(a.Z + t * (static_cast<double>(b.Z) - a.Z))
+                        };
+                        splits.push_back({edgeIndex, t, point});
+                        splits.push_back({otherIndex, EdgeParameter(c, d, point), point});
+                        continue;
+                    }
+
+                    //Touching and overlapping edges get split at the original points, those are exact
+                    if (o1 == 0 && IsBetween(a, b, c))
+                        splits.push_back({edgeIndex, EdgeParameter(a, b, c), c});
+                    if (o2 == 0 && IsBetween(a, b, d))
+                        splits.push_back({edgeIndex, EdgeParameter(a, b, d), d});
+                    if (o3 == 0 && IsBetween(c, d, a))
+                        splits.push_back({otherIndex, EdgeParameter(c, d, a), a});
+                    if (o4 == 0 && IsBetween(c, d, b))
+                        splits.push_back({otherIndex, EdgeParameter(c, d, b), b});
+                }
+                activeEdges.push_back(edgeIndex);
+            }
+
+            std::sort(splits.begin(), splits.end(), [](const EdgeSplit& a, const EdgeSplit& b)
+            {
+                return a.Edge != b.Edge ? a.Edge < b.Edge : a.T < b.T;
+            });
+
+            //Cut every edge into sub-edges between its split points, equal positions weld into one vertex
+            std::vector<Vector3> vertices;
+            std::unordered_map<uint64_t, int> vertexLookup;
+            const auto addVertex = [&](const Vector3& point)
+            {
+                const auto result = vertexLookup.emplace(PositionKey(point), static_cast<int>(vertices.size()));
+                if (result.second)
+                    vertices.push_back(point);
+                return result.first->second;
+            };
+
+            std::vector<UnionSubEdge> subEdges;
+            subEdges.reserve(edges.size() + splits.size());
+            size_t split = 0;
+            for (int edgeIndex = 0; edgeIndex < static_cast<int>(edges.size()); edgeIndex++)
+            {
+                const UnionEdge& edge = edges[edgeIndex];
+                int from = addVertex(edgeStart(edge));
+                for (; split < splits.size() && splits[split].Edge == edgeIndex; split++)
+                {
+                    const int to = addVertex(splits[split].Point);
+                    if (to != from)
+                        subEdges.push_back({from, to, edge.Polygon});
+                    from = to;
+                }
+                const int to = addVertex(edgeEnd(edge));
+                if (to != from)
+                    subEdges.push_back({from, to, edge.Polygon});
+            }
+
+            std::unordered_map<uint64_t, int> subEdgeLookup;
+            subEdgeLookup.reserve(subEdges.size());
+            for (int i = static_cast<int>(subEdges.size()) - 1; i >= 0; i--)
+            {
+                UnionSubEdge& subEdge = subEdges[i];
+                const auto result = subEdgeLookup.emplace(EdgeKey(subEdge.From, subEdge.To), i);
+                if (!result.second)
+                {
+                    subEdge.NextSame = result.first->second;
+                    result.first->second = i;
+                }
+            }
+
+            //A sub-edge is part of the union outline when no other polygon covers it. Edges that another polygon walks the other
+            //way are a seam between two areas, edges that another polygon walks the same way are kept once. Hole edges follow
+            //the same rules, a hole that another polygon covers closes
+            std::vector<unsigned char> sharesEdge(polygonCount, 0);
+            int keptCount = 0;
+            for (UnionSubEdge& subEdge : subEdges)
+            {
+                if (subEdgeLookup.count(EdgeKey(subEdge.To, subEdge.From)) != 0)
+                    continue;
+
+                bool bDuplicate = false;
+                for (int same = subEdgeLookup[EdgeKey(subEdge.From, subEdge.To)]; same != -1; same = subEdges[same].NextSame)
+                {
+                    bDuplicate |= subEdges[same].Polygon < subEdge.Polygon;
+                    sharesEdge[subEdges[same].Polygon] = 1;
+                }
+
+                const Vector3& from = vertices[subEdge.From];
+                const Vector3& to = vertices[subEdge.To];
+                const double midX = (static_cast<double>(from.X) + to.X) * 0.5;
+                const double midY = (static_cast<double>(from.Y) + to.Y) * 0.5;
+                bool bCovered = bDuplicate;
+                for (int p = 0; p < polygonCount && !bCovered; p++)
+                {
+                    const BoundingBox& box = boxes[group[p]];
+                    if (sharesEdge[p] || midX < box.MinX || midX > box.MaxX || midY < box.MinY || midY > box.MaxY)
+                        continue;
+                    bCovered = rowIndices[p].Contains(midX, midY);
+                }
+
+                for (int same = subEdgeLookup[EdgeKey(subEdge.From, subEdge.To)]; same != -1; same = subEdges[same].NextSame)
+                {
+                    sharesEdge[subEdges[same].Polygon] = 0;
+                }
+
+                subEdge.bKept = !bCovered;
+                keptCount += subEdge.bKept;
+            }
+
+            //Outgoing kept sub-edges per vertex
+            std::vector<int> outgoingStarts(vertices.size() + 1, 0);
+            for (const UnionSubEdge& subEdge : subEdges)
+            {
+                if (subEdge.bKept)
+                    outgoingStarts[subEdge.From + 1]++;
+            }
+            for (size_t i = 1; i < outgoingStarts.size(); i++)
+            {
+                outgoingStarts[i] += outgoingStarts[i - 1];
+            }
+            std::vector<int> outgoing(keptCount);
+            std::vector<int> outgoingFill(outgoingStarts.begin(), outgoingStarts.end() - 1);
+            for (int i = 0; i < static_cast<int>(subEdges.size()); i++)
+            {
+                if (subEdges[i].bKept)
+                    outgoing[outgoingFill[subEdges[i].From]++] = i;
+            }
+
+            //Walks the kept sub-edges into rings. Where rings touch in one vertex the walk takes the first edge clockwise from
+            //the way it came in, so touching rings stay apart
+            std::vector<unsigned char> used(subEdges.size(), 0);
+            std::vector<Vector3> ring;
+            for (int startEdge = 0; startEdge < static_cast<int>(subEdges.size()); startEdge++)
+            {
+                if (!subEdges[startEdge].bKept || used[startEdge])
+                    continue;
+
+                ring.clear();
+                const int startVertex = subEdges[startEdge].From;
+                int current = startEdge;
+                bool bClosed = false;
+                while (current != -1)
+                {
+                    used[current] = 1;
+                    const UnionSubEdge& subEdge = subEdges[current];
+                    ring.push_back(vertices[subEdge.From]);
+                    if (subEdge.To == startVertex)
+                    {
+                        bClosed = true;
+                        break;
+                    }
+
+                    const Vector3& from = vertices[subEdge.From];
+                    const Vector3& at = vertices[subEdge.To];
+                    const double backAngle = std::atan2(static_cast<double>(from.Y) - at.Y, static_cast<double>(from.X) - at.X);
+                    int next = -1;
+                    double bestTurn = 0.0;
+                    for (int i = outgoingStarts[subEdge.To]; i < outgoingStarts[subEdge.To + 1]; i++)
+                    {
+                        const int candidate = outgoing[i];
+                        if (used[candidate])
+                            continue;
+
+                        const Vector3& to = vertices[subEdges[candidate].To];
+                        double turn = backAngle - std::atan2(static_cast<double>(to.Y) - at.Y, static_cast<double>(to.X) - at.X);
+                        while (turn <= 0.0)
+                        {
+                            turn += 2.0 * 3.14159265358979323846;
+                        }
+                        if (next == -1 || turn < bestTurn)
+                        {
+                            next = candidate;
+                            bestTurn = turn;
+                        }
+                    }
+                    current = next;
+                }
+
+                //An open chain only happens when rounding broke a crossing apart, it gets left out instead of outlining garbage
+                if (!bClosed)
+                    continue;
+
+                RemoveCollinearPoints(ring);
+                if (ring.size() >= 3 && PolygonArea(ring) != 0.f)
+                    outRings.push_back(ring);
+            }
+        }
+
+        /// <summary>
+        /// Adds a polygon that is not merged with any other as a piece of its own
+        /// </summary>
+        void AddPolygonPiece(const UnionPolygon& polygon, const int source, std::vector<PolygonUnionPiece>& outPieces)
+        {
+            outPieces.emplace_back();
+            PolygonUnionPiece& piece = outPieces.back();
+            const int loopCount = static_cast<int>(polygon.LoopStarts.size()) - 1;
+            piece.Outer.assign(polygon.Points.begin(), polygon.Points.begin() + polygon.LoopStarts[1]);
+            for (int loop = 1; loop < loopCount; loop++)
+            {
+                piece.Holes.emplace_back(polygon.Points.begin() + polygon.LoopStarts[loop],
+                                         polygon.Points.begin() + polygon.LoopStarts[loop + 1]);
+            }
+            piece.SourcePolygons.push_back(source);
+        }
+    }
+
+    void UnionPolygons(const std::vector<std::vector<Vector3>>& polygons, const std::vector<std::vector<int>>& polygonHoleStarts,
+                       std::vector<PolygonUnionPiece>& outPieces)
+    {
+        outPieces.clear();
+        const int polygonCount = static_cast<int>(polygons.size());
+
+        //Cleaned loops, counter clockwise outlines and clockwise holes. Crossing polygons have no inside to merge and get
+        //passed through as they are
+        std::vector<UnionPolygon> cleaned(polygonCount);
+        std::vector<BoundingBox> boxes(polygonCount);
+        std::vector<unsigned char> mergeable(polygonCount, 0);
+        std::vector<Vector3> loopPoints;
+        Triangulator triangulator;
+        for (int i = 0; i < polygonCount; i++)
+        {
+            const std::vector<Vector3>& points = polygons[i];
+            const std::vector<int>* holeStarts = i < static_cast<int>(polygonHoleStarts.size()) ? &polygonHoleStarts[i] : nullptr;
+            const int holeCount = holeStarts != nullptr ? static_cast<int>(holeStarts->size()) : 0;
+            UnionPolygon& polygon = cleaned[i];
+            bool bSelfIntersecting = false;
+            for (int loop = 0; loop <= holeCount; loop++)
+            {
+                const int begin = loop > 0 ? (*holeStarts)[loop - 1] : 0;
+                const int end = loop < holeCount ? (*holeStarts)[loop] : static_cast<int>(points.size());
+                loopPoints.assign(points.begin() + begin, points.begin() + end);
+                const PolygonComponents& components = triangulator.ClassifyPoints(loopPoints);
+                const int ringCount = static_cast<int>(components.RingIndices.size());
+                if (ringCount < 3)
+                {
+                    //Holes without an outline have nothing to cut out of
+                    if (loop == 0)
+                        break;
+                    continue;
+                }
+
+                bSelfIntersecting |= components.bSelfIntersecting;
+                const int loopStart = static_cast<int>(polygon.Points.size());
+                polygon.LoopStarts.push_back(loopStart);
+                for (int j = 0; j < ringCount; j++)
+                {
+                    polygon.Points.push_back(loopPoints[components.RingIndices[loop > 0 ? ringCount - 1 - j : j]]);
+                    polygon.NextPoints.push_back(j + 1 < ringCount ? loopStart + j + 1 : loopStart);
+                }
+            }
+            if (polygon.Points.empty())
+                continue;
+
+            polygon.LoopStarts.push_back(static_cast<int>(polygon.Points.size()));
+            boxes[i] = GetBoundingBox(polygon.Points);
+            mergeable[i] = !bSelfIntersecting;
+            if (!mergeable[i])
+                AddPolygonPiece(polygon, i, outPieces);
+        }
+
+        //Broad phase, polygons end up in one group when their bounding boxes overlap directly or through other polygons
+        std::vector<int> order;
+        for (int i = 0; i < polygonCount; i++)
+        {
+            if (mergeable[i])
+                order.push_back(i);
+        }
+        std::sort(order.begin(), order.end(), [&boxes](const int a, const int b)
+        {
+            return boxes[a].MinX < boxes[b].MinX;
+        });
+
+        std::vector<int> parents(polygonCount);
+        for (int i = 0; i < polygonCount; i++)
+        {
+            parents[i] = i;
+        }
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            for (size_t j = i + 1; j < order.size() && boxes[order[j]].MinX <= boxes[order[i]].MaxX; j++)
+            {
+                if (BoxesOverlap(boxes[order[i]], boxes[order[j]]))
+                    parents[FindRoot(parents, order[i])] = FindRoot(parents, order[j]);
+            }
+        }
+
+        std::vector<std::vector<int>> groups;
+        std::vector<int> groupOfRoot(polygonCount, -1);
+        for (int i = 0; i < polygonCount; i++)
+        {
+            if (!mergeable[i])
+                continue;
+
+            const int root = FindRoot(parents, i);
+            if (groupOfRoot[root] == -1)
+            {
+                groupOfRoot[root] = static_cast<int>(groups.size());
+                groups.emplace_back();
+            }
+            groups[groupOfRoot[root]].push_back(i);
+        }
+
+        std::vector<std::vector<Vector3>> groupRings;
+        std::vector<float> ringAreas;
+        for (const std::vector<int>& group : groups)
+        {
+            if (group.size() == 1)
+            {
+                AddPolygonPiece(cleaned[group[0]], group[0], outPieces);
+                continue;
+            }
+
+            groupRings.clear();
+            UnionGroup(cleaned, boxes, group, groupRings);
+
+            //Every gap goes to the smallest outline around it, outlines can sit in the gap of another outline
+            const size_t firstPiece = outPieces.size();
+            ringAreas.resize(groupRings.size());
+            for (size_t i = 0; i < groupRings.size(); i++)
+            {
+                ringAreas[i] = PolygonArea(groupRings[i]);
+                if (ringAreas[i] > 0.f)
+                {
+                    outPieces.emplace_back();
+                    PolygonUnionPiece& piece = outPieces.back();
+                    piece.Outer = std::move(groupRings[i]);
+                    piece.SourcePolygons = group;
+                }
+            }
+
+            for (size_t i = 0; i < groupRings.size(); i++)
+            {
+                if (ringAreas[i] > 0.f)
+                    continue;
+
+                //The middle of an edge of the gap never lies on another outline, those edges would have been merged away
+                const std::vector<Vector3>& hole = groupRings[i];
+                const double midX = (static_cast<double>(hole[0].X) + hole[1].X) * 0.5;
+                const double midY = (static_cast<double>(hole[0].Y) + hole[1].Y) * 0.5;
+                int owner = -1;
+                float ownerArea = 0.f;
+                for (size_t p = firstPiece; p < outPieces.size(); p++)
+                {
+                    const float area = PolygonArea(outPieces[p].Outer);
+                    if ((owner == -1 || area < ownerArea) && IsPointInRing(outPieces[p].Outer, midX, midY))
+                    {
+                        owner = static_cast<int>(p);
+                        ownerArea = area;
+                    }
+                }
+                if (owner != -1)
+                    outPieces[owner].Holes.push_back(std::move(groupRings[i]));
+            }
+        }
+    }
+}
@@ -0,0 +1,458 @@
+// Copyright 2021 Robin Smekens
+
+#include "USplineAreaSubsystem.h"
+#include "ASplineArea.h"
+#include "SplineArea.h"
+#include "SplineAreaGeometry.h"
+#include "ProceduralMeshComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Async/ParallelFor.h"
+#include "Materials/MaterialInterface.h"
+
+void USplineAreaSubsystem::Deinitialize()
+{
+    //The batch actor is transient and goes away with the world
+    Batches.Reset();
+    AreaEntries.Reset();
+    BatchActor = nullptr;
+
+    Super::Deinitialize();
+}
+
+void USplineAreaSubsystem::Tick(float DeltaTime)
+{
+    FlushBatches();
+}
+
+bool USplineAreaSubsystem::IsTickable() const
+{
+    for (const FSplineAreaBatch& batch : Batches)
+    {
+        if (batch.bHasDirtyEntries || batch.bLayoutDirty)
+            return true;
+    }
+    return false;
+}
+
+ETickableTickType USplineAreaSubsystem::GetTickableTickType() const
+{
+    return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+bool USplineAreaSubsystem::IsTickableWhenPaused() const
+{
+    return true;
+}
+
+UWorld* USplineAreaSubsystem::GetTickableGameObjectWorld() const
+{
+    return GetWorld();
+}
+
+TStatId USplineAreaSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(USplineAreaSubsystem, STATGROUP_Tickables);
+}
+
+void USplineAreaSubsystem::RegisterArea(const ASplineArea* area)
+{
+    if (area == nullptr || AreaEntries.Contains(area))
+        return;
+
+    const int32 batchIndex = FindOrAddBatch(area);
+    FSplineAreaBatch& batch = Batches[batchIndex];
+
+    FSplineAreaBatchEntry& entry = batch.Entries.AddDefaulted_GetRef();
+    entry.Area = area;
+    batch.bLayoutDirty = true;
+    AreaEntries.Add(area, FIntPoint(batchIndex, batch.Entries.Num() - 1));
+}
+
+void USplineAreaSubsystem::UnregisterArea(const ASplineArea* area)
+{
+    FIntPoint location;
+    if (!AreaEntries.RemoveAndCopyValue(area, location))
+        return;
+
+    //The last entry takes the free slot, the ranges get packed again on the next flush
+    FSplineAreaBatch& batch = Batches[location.X];
+    batch.Entries.RemoveAtSwap(location.Y, 1, false);
+    if (batch.Entries.IsValidIndex(location.Y))
+    {
+        if (const ASplineArea* movedArea = batch.Entries[location.Y].Area.Get(true))
+            AreaEntries.Add(movedArea, location);
+    }
+    batch.bLayoutDirty = true;
+}
+
+bool USplineAreaSubsystem::IsAreaRegistered(const ASplineArea* area) const
+{
+    return AreaEntries.Contains(area);
+}
+
+void USplineAreaSubsystem::MarkAreaDirty(const ASplineArea* area)
+{
+    FSplineAreaBatch* batch = nullptr;
+    if (FSplineAreaBatchEntry* entry = FindEntry(area, batch))
+    {
+        entry->bDirty = true;
+        batch->bHasDirtyEntries = true;
+    }
+}
+
+void USplineAreaSubsystem::SetAreaVisible(const ASplineArea* area, const bool bVisible)
+{
+    FSplineAreaBatch* batch = nullptr;
+    FSplineAreaBatchEntry* entry = FindEntry(area, batch);
+    if (entry == nullptr || entry->bVisible == bVisible)
+        return;
+
+    entry->bVisible = bVisible;
+    entry->bDirty = true;
+    batch->bHasDirtyEntries = true;
+}
+
+void USplineAreaSubsystem::RegenerateAllAreas()
+{
+    SPLINEAREA_SCOPE(RegenerateAllAreas);
+
+    TArray<ASplineArea*> areas;
+    for (TActorIterator<ASplineArea> it(GetWorld()); it; ++it)
+    {
+        areas.Add(*it);
+    }
+
+    TArray<FSplineAreaBuildData> buildData;
+    buildData.SetNum(areas.Num());
+    for (int32 i = 0; i < areas.Num(); i++)
+    {
+        areas[i]->SnapshotBuildData(buildData[i]);
+    }
+
+    ParallelFor(areas.Num(), [&buildData](const int32 i)
+    {
+        ASplineArea::BuildAreaData(buildData[i]);
+    });
+
+    //Batched areas only mark their range here, the batches get written once at the end
+    for (int32 i = 0; i < areas.Num(); i++)
+    {
+        areas[i]->ApplyBuildData(MoveTemp(buildData[i]));
+    }
+    FlushBatches();
+}
+
+void USplineAreaSubsystem::FlushBatches()
+{
+    SPLINEAREA_SCOPE(FlushBatches);
+
+    for (FSplineAreaBatch& batch : Batches)
+    {
+        //Any change can move the union outline, so merged batches never patch ranges
+        if (batch.bMergeAreas && batch.bHasDirtyEntries)
+            batch.bLayoutDirty = true;
+
+        if (!batch.bLayoutDirty && batch.bHasDirtyEntries)
+        {
+            bool bPatchedEntries = false;
+            bool bIndicesChanged = false;
+            for (FSplineAreaBatchEntry& entry : batch.Entries)
+            {
+                if (!entry.bDirty)
+                    continue;
+
+                bool bEntryIndicesChanged = false;
+                if (!PatchEntry(batch, entry, bEntryIndicesChanged))
+                {
+                    batch.bLayoutDirty = true;
+                    break;
+                }
+                entry.bDirty = false;
+                bPatchedEntries = true;
+                bIndicesChanged |= bEntryIndicesChanged;
+            }
+
+            if (!batch.bLayoutDirty && bPatchedEntries)
+            {
+                //The procedural mesh has no partial updates, but the section only gets recreated when triangles changed
+                if (bIndicesChanged)
+                {
+                    batch.Mesh->CreateMeshSection(0, batch.Vertices, batch.Indices, TArray<FVector>(), batch.UVs,
+                                                  TArray<FColor>(), TArray<FProcMeshTangent>(), false);
+                }
+                else
+                {
+                    batch.Mesh->UpdateMeshSection(0, batch.Vertices, TArray<FVector>(), batch.UVs, TArray<FColor>(),
+                                                  TArray<FProcMeshTangent>());
+                }
+                batch.Outline->MarkRenderStateDirty();
+            }
+        }
+
+        if (batch.bLayoutDirty)
+            RebuildBatch(batch);
+
+        batch.bHasDirtyEntries = false;
+        batch.bLayoutDirty = false;
+    }
+}
+
+FSplineAreaBatchEntry* USplineAreaSubsystem::FindEntry(const ASplineArea* area, FSplineAreaBatch*& outBatch)
+{
+    const FIntPoint* location = AreaEntries.Find(area);
+    if (location == nullptr)
+        return nullptr;
+
+    outBatch = &Batches[location->X];
+    return &outBatch->Entries[location->Y];
+}
+
+int32 USplineAreaSubsystem::FindOrAddBatch(const ASplineArea* area)
+{
+    UMaterialInterface* meshMaterial = area->GetAreaMeshMaterial();
+    UMaterialInterface* outlineMaterial = area->GetAreaOutlineMaterial();
+    UStaticMesh* outlineMesh = area->GetAreaOutlineMesh();
+    const bool bMergeAreas = area->ShouldMergeOverlappingAreas();
+    const float outlineWidth = bMergeAreas ? area->GetAreaOutlineWidth() : 0.f;
+    const float uvTileSize = bMergeAreas ? area->GetAreaUVTileSize() : 1.f;
+
+    for (int32 i = 0; i < Batches.Num(); i++)
+    {
+        const FSplineAreaBatch& batch = Batches[i];
+        if (batch.MeshMaterial == meshMaterial && batch.OutlineMaterial == outlineMaterial && batch.OutlineMesh == outlineMesh &&
+            batch.bMergeAreas == bMergeAreas && batch.OutlineWidth == outlineWidth && batch.UVTileSize == uvTileSize)
+            return i;
+    }
+
+    //All batch components live on one transient actor at the origin, so the batch buffers are in world space
+    if (BatchActor == nullptr)
+    {
+        FActorSpawnParameters spawnParameters;
+        spawnParameters.ObjectFlags |= RF_Transient;
+        spawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+        BatchActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, spawnParameters);
+
+        USceneComponent* root = NewObject<USceneComponent>(BatchActor, TEXT("Root"));
+        BatchActor->SetRootComponent(root);
+        root->RegisterComponent();
+    }
+
+    FSplineAreaBatch& batch = Batches.AddDefaulted_GetRef();
+    batch.MeshMaterial = meshMaterial;
+    batch.OutlineMaterial = outlineMaterial;
+    batch.OutlineMesh = outlineMesh;
+    batch.bMergeAreas = bMergeAreas;
+    batch.OutlineWidth = outlineWidth;
+    batch.UVTileSize = uvTileSize;
+
+    batch.Mesh = NewObject<UProceduralMeshComponent>(BatchActor);
+    batch.Mesh->SetupAttachment(BatchActor->GetRootComponent());
+    batch.Mesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    batch.Mesh->RegisterComponent();
+
+    batch.Outline = NewObject<UInstancedStaticMeshComponent>(BatchActor);
+    batch.Outline->SetupAttachment(BatchActor->GetRootComponent());
+    batch.Outline->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    batch.Outline->SetStaticMesh(outlineMesh);
+    batch.Outline->SetMaterial(0, outlineMaterial);
+    batch.Outline->RegisterComponent();
+
+    return Batches.Num() - 1;
+}
+
+void USplineAreaSubsystem::RebuildBatch(FSplineAreaBatch& batch) const
+{
+    if (batch.bMergeAreas)
+    {
+        RebuildMergedBatch(batch);
+        return;
+    }
+
+    int32 vertexCount = 0;
+    int32 indexCount = 0;
+    int32 instanceCount = 0;
+    for (FSplineAreaBatchEntry& entry : batch.Entries)
+    {
+        const ASplineArea* area = entry.Area.Get();
+        entry.VertexStart = vertexCount;
+        entry.IndexStart = indexCount;
+        entry.InstanceStart = instanceCount;
+        entry.VertexCount = area != nullptr ? area->GetAreaVertices().Num() : 0;
+        entry.IndexCount = area != nullptr ? area->GetAreaIndices().Num() : 0;
+        entry.InstanceCount = area != nullptr ? area->GetOutlineTransforms().Num() : 0;
+        entry.bDirty = false;
+
+        vertexCount += entry.VertexCount;
+        indexCount += entry.IndexCount;
+        instanceCount += entry.InstanceCount;
+    }
+
+    batch.Vertices.SetNumUninitialized(vertexCount, false);
+    batch.UVs.SetNumUninitialized(vertexCount, false);
+    batch.Indices.SetNumUninitialized(indexCount, false);
+    batch.OutlineTransforms.SetNumUninitialized(instanceCount, false);
+
+    for (const FSplineAreaBatchEntry& entry : batch.Entries)
+    {
+        if (entry.VertexCount == 0 && entry.InstanceCount == 0)
+            continue;
+
+        WriteEntryData(batch, entry);
+        const TArray<int32>& areaIndices = entry.Area->GetAreaIndices();
+        for (int32 i = 0; i < entry.IndexCount; i++)
+        {
+            batch.Indices[entry.IndexStart + i] = areaIndices[i] + entry.VertexStart;
+        }
+    }
+
+    batch.Mesh->CreateMeshSection(0, batch.Vertices, batch.Indices, TArray<FVector>(), batch.UVs, TArray<FColor>(),
+                                  TArray<FProcMeshTangent>(), false);
+    batch.Mesh->SetMaterial(0, batch.MeshMaterial);
+    ASplineArea::ApplyInstanceTransforms(batch.Outline, batch.OutlineTransforms);
+}
+
+void USplineAreaSubsystem::RebuildMergedBatch(FSplineAreaBatch& batch) const
+{
+    SPLINEAREA_SCOPE(MergeAreas);
+
+    //World space outlines and holes of the visible areas, the entries keep no ranges since the union has no per area data
+    std::vector<std::vector<SplineAreaGeometry::Vector3>> polygons;
+    std::vector<std::vector<int>> polygonHoleStarts;
+    for (FSplineAreaBatchEntry& entry : batch.Entries)
+    {
+        entry.VertexCount = 0;
+        entry.IndexCount = 0;
+        entry.InstanceCount = 0;
+        entry.bDirty = false;
+
+        const ASplineArea* area = entry.Area.Get();
+        if (area == nullptr || !entry.bVisible || area->GetAreaIndices().Num() == 0)
+            continue;
+
+        const TArray<FVector>& areaVertices = area->GetAreaVertices();
+        const TArray<int32>& areaHoleStarts = area->GetAreaHoleStarts();
+        const FTransform meshTransform = area->GetAreaMeshTransform();
+        polygons.emplace_back();
+        std::vector<SplineAreaGeometry::Vector3>& polygon = polygons.back();
+        polygon.reserve(areaVertices.Num());
+        for (const FVector& vertex : areaVertices)
+        {
+            const FVector worldVertex = meshTransform.TransformPosition(vertex);
+            polygon.push_back({worldVertex.X, worldVertex.Y, worldVertex.Z});
+        }
+        polygonHoleStarts.emplace_back(areaHoleStarts.GetData(), areaHoleStarts.GetData() + areaHoleStarts.Num());
+    }
+
+    std::vector<SplineAreaGeometry::PolygonUnionPiece> pieces;
+    SplineAreaGeometry::UnionPolygons(polygons, polygonHoleStarts, pieces);
+
+    batch.Vertices.Reset();
+    batch.UVs.Reset();
+    batch.Indices.Reset();
+    batch.OutlineTransforms.Reset();
+
+    //Every piece is triangulated with its holes in one pass, the gaps between areas and the holes of the areas alike
+    const float uvScale = 1.f / batch.UVTileSize;
+    std::vector<SplineAreaGeometry::Vector3> piecePoints;
+    std::vector<int> pieceHoleStarts;
+    std::vector<int> indices;
+    TArray<FVector> outline;
+    TArray<int32> outlineHoleStarts;
+    for (const SplineAreaGeometry::PolygonUnionPiece& piece : pieces)
+    {
+        piecePoints = piece.Outer;
+        pieceHoleStarts.clear();
+        for (const std::vector<SplineAreaGeometry::Vector3>& hole : piece.Holes)
+        {
+            pieceHoleStarts.push_back(static_cast<int>(piecePoints.size()));
+            piecePoints.insert(piecePoints.end(), hole.begin(), hole.end());
+        }
+
+        indices.clear();
+        SplineAreaGeometry::TriangulatePolygonWithHoles(piecePoints, pieceHoleStarts, indices);
+
+        const int32 vertexStart = batch.Vertices.Num();
+        outline.Reset();
+        for (const SplineAreaGeometry::Vector3& point : piecePoints)
+        {
+            outline.Add(FVector(point.X, point.Y, point.Z));
+            batch.UVs.Add(FVector2D(point.X * uvScale, point.Y * uvScale));
+        }
+        batch.Vertices.Append(outline);
+        for (const int index : indices)
+        {
+            batch.Indices.Add(index + vertexStart);
+        }
+
+        //Seams between the areas are gone from the union, so the outline only follows the outer boundary and the holes
+        if (batch.OutlineWidth > 0.f)
+        {
+            outlineHoleStarts.Reset();
+            outlineHoleStarts.Append(pieceHoleStarts.data(), pieceHoleStarts.size());
+            ASplineArea::BuildOutlineTransforms(outline, outlineHoleStarts, batch.OutlineWidth, batch.OutlineTransforms);
+        }
+    }
+
+    batch.Mesh->CreateMeshSection(0, batch.Vertices, batch.Indices, TArray<FVector>(), batch.UVs, TArray<FColor>(),
+                                  TArray<FProcMeshTangent>(), false);
+    batch.Mesh->SetMaterial(0, batch.MeshMaterial);
+    ASplineArea::ApplyInstanceTransforms(batch.Outline, batch.OutlineTransforms);
+}
+
+bool USplineAreaSubsystem::PatchEntry(FSplineAreaBatch& batch, FSplineAreaBatchEntry& entry, bool& bOutIndicesChanged) const
+{
+    const ASplineArea* area = entry.Area.Get();
+    if (area == nullptr || area->GetAreaVertices().Num() != entry.VertexCount ||
+        area->GetAreaIndices().Num() != entry.IndexCount || area->GetOutlineTransforms().Num() != entry.InstanceCount)
+        return false;
+
+    const TArray<int32>& areaIndices = area->GetAreaIndices();
+    for (int32 i = 0; i < entry.IndexCount; i++)
+    {
+        const int32 index = areaIndices[i] + entry.VertexStart;
+        if (batch.Indices[entry.IndexStart + i] != index)
+        {
+            batch.Indices[entry.IndexStart + i] = index;
+            bOutIndicesChanged = true;
+        }
+    }
+
+    WriteEntryData(batch, entry);
+    if (entry.InstanceCount > 0)
+    {
+        const TArray<FTransform> entryTransforms(batch.OutlineTransforms.GetData() + entry.InstanceStart, entry.InstanceCount);
+        batch.Outline->BatchUpdateInstancesTransforms(entry.InstanceStart, entryTransforms, false, false, true);
+    }
+    return true;
+}
+
+void USplineAreaSubsystem::WriteEntryData(FSplineAreaBatch& batch, const FSplineAreaBatchEntry& entry) const
+{
+    const ASplineArea* area = entry.Area.Get();
+
+    //Hidden areas collapse onto their first vertex, so their triangles have no area and get culled by the GPU
+    const TArray<FVector>& areaVertices = area->GetAreaVertices();
+    const TArray<FVector2D>& areaUVs = area->GetAreaUVs();
+    const FTransform meshTransform = area->GetAreaMeshTransform();
+    const FVector collapsedVertex = entry.VertexCount > 0 ? meshTransform.TransformPosition(areaVertices[0]) : FVector::ZeroVector;
+    for (int32 i = 0; i < entry.VertexCount; i++)
+    {
+        batch.Vertices[entry.VertexStart + i] = entry.bVisible
+                                                    ? meshTransform.TransformPosition(areaVertices[i])
+                                                    : collapsedVertex;
+        batch.UVs[entry.VertexStart + i] = areaUVs[i];
+    }
+
+    const TArray<FTransform>& areaOutline = area->GetOutlineTransforms();
+    const FTransform outlineTransform = area->GetAreaOutlineTransform();
+    for (int32 i = 0; i < entry.InstanceCount; i++)
+    {
+        FTransform instanceTransform = areaOutline[i] * outlineTransform;
+        if (!entry.bVisible)
+            instanceTransform.SetScale3D(FVector::ZeroVector);
+        batch.OutlineTransforms[entry.InstanceStart + i] = instanceTransform;
+    }
+}
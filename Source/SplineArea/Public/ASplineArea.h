@@ -4,18 +4,72 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "ProceduralMeshComponent.h"
+#include "SplineAreaGeometry.h"
 #include "ASplineArea.generated.h"
 
 class USplineComponent;
 class UProceduralMeshComponent;
 class UMaterialInterface;
 class UInstancedStaticMeshComponent;
+class UStaticMesh;
+class ASplineArea;
 
-struct MeshTriangle
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSplineAreaGenerated, ASplineArea*, Area);
+
+/// <summary>
+/// Triangulation and outline of an area, built from a snapshot of the spline points so it can be made off the game thread
+/// </summary>
+struct FSplineAreaBuildData
+{
+    //The outline followed by the points of every hole, HoleStarts holds the index of the first point of every hole
+    TArray<FVector> Vertices;
+    TArray<int32> HoleStarts;
+    TArray<int32> Indices;
+    TArray<FTransform> OutlineTransforms;
+    float OutlineWidth = 0.f;
+    bool bBuildOutline = false;
+    uint32 AreaHash = 0;
+    bool bSelfIntersecting = false;
+};
+
+/// <summary>
+/// Shape of the collision of an area
+/// </summary>
+UENUM(BlueprintType)
+enum class ESplineAreaCollision : uint8
+{
+    //Every triangle of the area, cooked as a triangle mesh and used for simple and complex queries
+    Triangles,
+    //A few thin convex pieces from a convex partition of the area, used as simple collision
+    ConvexPieces,
+};
+
+/// <summary>
+/// Simplified version of the area that gets drawn once the area gets small on screen
+/// </summary>
+USTRUCT(BlueprintType)
+struct FSplineAreaLOD
+{
+    GENERATED_BODY()
+
+    //Largest distance in world units between the full outline and the simplified one
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Default, meta = (ClampMin = "0.0"))
+    float MaxError = 10.f;
+
+    //The LOD gets used once the bounds of the area cover less than this part of the screen
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Default, meta = (ClampMin = "0.0", ClampMax = "1.0"))
+    float ScreenSize = 0.3f;
+};
+
+/// <summary>
+/// Generated data of one LOD, the mesh section of LOD i is section i + 1
+/// </summary>
+struct FSplineAreaLODData
 {
-    FVector point1 = FVector();
-    FVector point2 = FVector();
-    FVector point3 = FVector();
+    TArray<FVector> Vertices;
+    TArray<int32> Indices;
+    TArray<FTransform> OutlineTransforms;
 };
 
 UCLASS()
@@ -28,9 +82,61 @@ public:
     ASplineArea();
 
 private:
-    TArray<MeshTriangle> VisualizationTriangles;
+    TArray<FVector> AreaVertices;
     float StandardSize = 50.f;
 
+    //The generated area is saved with the level so loading does not need to triangulate again, CachedAreaHash is the hash of
+    //the spline points and outline settings the cache was made from
+    UPROPERTY()
+    TArray<int32> AreaIndices;
+    //AreaVertices holds the outline followed by the holes, these are the indices of the first point of every hole
+    UPROPERTY()
+    TArray<int32> AreaHoleStarts;
+    UPROPERTY()
+    TArray<FTransform> CachedOutlineTransforms;
+    UPROPERTY()
+    uint32 CachedAreaHash = 0;
+
+    //Serial of the latest generation request, async results with an older serial are stale and get dropped
+    TSharedRef<FThreadSafeCounter, ESPMode::ThreadSafe> GenerationSerial = MakeShared<
+        FThreadSafeCounter, ESPMode::ThreadSafe>();
+    bool bAsyncGenerationInFlight = false;
+    bool bAsyncGenerationPending = false;
+
+    //Vertex streams handed to the mesh section, kept between rebuilds so they only reallocate when the point count grows
+    mutable TArray<FVector2D> MeshUVs;
+    mutable TArray<FVector> MeshNormals;
+    mutable TArray<FProcMeshTangent> MeshTangents;
+    mutable TArray<FColor> MeshColors;
+
+    //Only built while the game runs, LOD 0 is the full area
+    TArray<FSplineAreaLODData> LODData;
+    int32 CurrentLOD = 0;
+    FTimerHandle LODTimerHandle;
+
+    //Set while the area is drawn by the USplineAreaSubsystem batch instead of its own components
+    bool bRegisteredInBatch = false;
+
+    //Built on the first query after the triangulation changed, queries are expected on the game thread
+    mutable SplineAreaGeometry::AreaQueryGrid AreaQuery;
+    mutable bool bAreaQueryDirty = true;
+
+    //Triangles around every area vertex for the local updates of single point edits, built on the first edit after a full
+    //triangulation. The local updates can not repair a crossing outline, so they stay off until a full triangulation is clean
+    SplineAreaGeometry::PointTriangleAdjacency AreaAdjacency;
+    bool bAreaAdjacencyDirty = true;
+    bool bAreaSelfIntersecting = true;
+
+    //Last state passed to SetAreaActive, a released area applies it once its components get created again
+    bool bAreaActive = true;
+    //Cleared while a lazy area has released its mesh, collision and outline, only the generated data is kept then
+    bool bAreaResident = true;
+    FTimerHandle RelevanceTimerHandle;
+    TWeakObjectPtr<AActor> RelevanceSource;
+    //Bounds of AreaVertices relative to the area mesh, refreshed on the first relevance check after the vertices changed
+    FBox AreaLocalBounds = FBox(ForceInit);
+    bool bAreaBoundsDirty = true;
+
 protected:
     UPROPERTY(VisibleDefaultsOnly, BlueprintReadWrite, Category = Default)
     USplineComponent* pSpline = nullptr;
@@ -49,84 +155,353 @@ protected:
     UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = Default, meta = (EditCondition = "bEnableOutline"))
     float OutlineWidth = 2.f;
 
+    //Follows the curve of the spline instead of forcing every point to linear, the curve gets flattened into as few points as
+    //possible while staying within CurveTolerance of it
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Default)
+    bool bCurvedArea = false;
+
+    //Largest distance in world units between the curve and the flattened area outline
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Default,
+        meta = (EditCondition = "bCurvedArea", ClampMin = "0.1"))
+    float CurveTolerance = 2.f;
+
+    //World units covered by one UV tile, the area UVs are projected on the XY plane
+    UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = Default, meta = (ClampMin = "1.0"))
+    float AreaUVTileSize = 100.f;
+
+    //Leaves out the normal, tangent and color streams, the mesh section fills in an up normal and white vertex color instead
+    UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = Default)
+    bool bSkipConstantVertexStreams = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Default)
+    ESplineAreaCollision CollisionMode = ESplineAreaCollision::Triangles;
+
+    //How far the convex collision pieces reach below the area surface
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Default,
+        meta = (EditCondition = "CollisionMode == ESplineAreaCollision::ConvexPieces", ClampMin = "0.1"))
+    float CollisionThickness = 5.f;
+
+    //Simplified versions of the area from detailed to coarse, every LOD gets its own mesh section and outline. Not used for
+    //batched areas
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Default)
+    TArray<FSplineAreaLOD> AreaLODs;
+
+    //Seconds between two checks of the screen size of the area
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Default, meta = (ClampMin = "0.05"))
+    float LODUpdateInterval = 0.25f;
+
+    //Draws the area through the USplineAreaSubsystem together with all other areas that use the same materials, the area keeps
+    //its own collision. The shared section leaves out the constant vertex streams like bSkipConstantVertexStreams
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Default)
+    bool bUseSharedBatch = false;
+
+    //Draws the area through the USplineAreaSubsystem merged with every overlapping area that uses the same materials, the union
+    //gets triangulated once and only its outer boundary and holes get an outline. Implies bUseSharedBatch, the area keeps its own
+    //collision
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Default)
+    bool bMergeOverlappingAreas = false;
+
+    //Only keeps the mesh, collision and outline while a relevance source is within ActivationRadius of the area, the area holds
+    //on to its generated vertices and triangles otherwise so creating them again does not triangulate. Queries like
+    //IsLocationInArea keep working while the resources are released
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Default)
+    bool bLazyActivation = false;
+
+    //Distance in world units between a relevance source and the bounds of the area at which the resources get created
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Default, meta = (EditCondition = "bLazyActivation", ClampMin = "0.0"))
+    float ActivationRadius = 3000.f;
+
+    //Extra distance the source has to move past ActivationRadius before the resources get released, so a source on the edge
+    //of the radius does not rebuild the area on every check
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Default, meta = (EditCondition = "bLazyActivation", ClampMin = "0.0"))
+    float ReleaseHysteresis = 500.f;
+
+    //Seconds between two relevance checks
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Default,
+        meta = (EditCondition = "bLazyActivation", ClampMin = "0.05"))
+    float RelevanceUpdateInterval = 0.5f;
+
 protected:
     // Called when the game starts or when spawned
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
     /// <summary>
-    /// Creates starting array of reflex, convex, ear vertices. Returns the final mesh triangles
+    /// Triangulates the spline points with SplineAreaGeometry, the spline points become AreaVertices and the triangles index into them
     /// </summary>
     void TriangulateSpline();
     /// <summary>
-    /// Create the procedural mesh based on the spline data (data produced by CreateTeleportationArea function)
+    /// Collects the outline and the holes of the area, the points of every hole spline get moved into the space of the
+    /// outline spline
+    /// </summary>
+    /// <param name="outPoints"> Array that will hold the outline followed by the points of every hole afterwards </param>
+    /// <param name="outHoleStarts"> Array that will hold the index of the first point of every hole afterwards </param>
+    void GetAreaPoints(TArray<FVector>& outPoints, TArray<int32>& outHoleStarts) const;
+    /// <summary>
+    /// Every spline component of the actor besides the outline spline cuts a hole out of the area
+    /// </summary>
+    void GetHoleSplines(TArray<USplineComponent*>& outHoleSplines) const;
+    /// <summary>
+    /// Compares the spline points with the ones of the last triangulation. When a single point moved, got inserted or got removed
+    /// only the triangles around it get re-triangulated, returns false when a full triangulation is needed instead
+    /// </summary>
+    /// <param name="splinePoints"> Current positional data of the spline </param>
+    /// <param name="bOutIndicesChanged"> Is false afterwards when the index buffer stayed the same and only vertices moved </param>
+    bool RetriangulateChangedPoints(const TArray<FVector>& splinePoints, bool& bOutIndicesChanged);
+    /// <summary>
+    /// Create the procedural mesh based on the spline data (data produced by CreateTeleportationArea function).
+    /// When the mesh section already holds the same index buffer only the vertices get updated
     /// </summary>
     void CreateAreaMesh() const;
     /// <summary>
+    /// Pushes only the vertex positions and UVs to the existing mesh section, used when the index buffer did not change
+    /// </summary>
+    void UpdateAreaMeshVertices() const;
+    /// <summary>
+    /// Builds the convex collision pieces in ConvexPieces mode, or switches the mesh section back to triangle collision
+    /// </summary>
+    void UpdateAreaCollision() const;
+    /// <summary>
+    /// Fills the reusable vertex streams for the current AreaVertices, the constant streams are only rewritten when the
+    /// vertex count changed
+    /// </summary>
+    void UpdateMeshStreams() const;
+    /// <summary>
     /// Creates instances of meshes to create an outline effect around the generated area
     /// </summary>
-    void CreateAreaOutline() const;
+    void CreateAreaOutline();
+    /// <summary>
+    /// Replaces the outline instances with the given transforms, they are relative to the outline component.
+    /// Stays empty while the area is drawn by a batch
+    /// </summary>
+    void ApplyAreaOutline(const TArray<FTransform>& outlineTransforms) const;
+    /// <summary>
+    /// Simplifies the area for every entry in AreaLODs and creates their hidden mesh sections, goes back to LOD 0
+    /// </summary>
+    void CreateAreaLODs();
+    /// <summary>
+    /// Picks the LOD that fits the screen size of the area for the first local player, runs on a timer
+    /// </summary>
+    void UpdateAreaLOD();
 
     /// <summary>
-    /// Figures out which spline points are convex, reflex, ear. Based on this we create an index table for each type.
+    /// Creates or releases the resources of a lazy area based on the distance to its relevance source, runs on a timer
     /// </summary>
-    /// <param name="splinePoints"> Needs a copy of the positional data of the spline </param>
-    /// <param name="reflexPoints"> Empty array that will hold the reflex points afterwards </param>
-    /// <param name="convexPoints"> Empty array that will hold the convex points afterwards </param>
-    /// <param name="earPoints"> Empty array that will hold the earPoints afterwards </param>
-    /// <param name="reflexIndices"> Empty array that will hold the reflex indices </param>
-    /// <param name="convexIndices"> Empty array that will hold the convex indices </param>
-    /// <param name="earIndices"> Empty array that will hold the ear indices </param>
-    void GetPolygonComponents(const TArray<FVector>& splinePoints,
-                              TArray<FVector>& reflexPoints, TArray<FVector>& convexPoints, TArray<FVector>& earPoints,
-                              TArray<int>& reflexIndices, TArray<int>& convexIndices, TArray<int>& earIndices) const;
+    void UpdateAreaRelevance();
+    /// <summary>
+    /// Finds the location the relevance of the area is measured from, that is the relevance source, the pawn of the first
+    /// local player or its camera. Returns false when there is none
+    /// </summary>
+    bool GetRelevanceLocation(FVector& outLocation) const;
+    /// <summary>
+    /// Creates the mesh, collision, outline and LODs from the generated data and applies the state of SetAreaActive
+    /// </summary>
+    void CreateAreaResources();
+    /// <summary>
+    /// Frees the mesh sections, collision, outline instances and vertex streams, the generated data stays
+    /// </summary>
+    void ReleaseAreaResources();
+    /// <summary>
+    /// Pushes the state of SetAreaActive to the components, or to the batch range of a batched area
+    /// </summary>
+    void ApplyAreaActiveState() const;
+
+    /// <summary>
+    /// Lets the batch know the generated data changed, does nothing when the area is not batched
+    /// </summary>
+    void MarkBatchDirty() const;
 
     /// <summary>
-    /// From the different types of vertices can figure out how the triangles need to laid out for the mesh
+    /// Hashes everything the generated area depends on, the cache is only valid for the hash it got made with
     /// </summary>
-    /// <param name="splinePoints"> Needs a copy of the positional data of the spline </param>
-    /// <param name="inConvexIndices"> Empty array that will hold the reflex points afterwards </param>
-    /// <param name="inReflexIndices"> Empty array that will hold the convex points afterwards </param>
-    /// <param name="inEarIndices"> Empty array that will hold the earPoints afterwards </param>
-    void TrianglesFromPoints(TArray<FVector>& splinePoints, const TArray<int>& inConvexIndices,
-                             const TArray<int>& inReflexIndices, const TArray<
-                                 int>& inEarIndices);
+    /// <param name="splinePoints"> Positional data of the spline and its holes </param>
+    /// <param name="holeStarts"> Index of the first point of every hole </param>
+    uint32 ComputeAreaHash(const TArray<FVector>& splinePoints, const TArray<int32>& holeStarts) const;
+    /// <summary>
+    /// Creates the mesh and outline straight from the cached buffers, returns false when the cache does not match the spline
+    /// </summary>
+    bool CreateTeleportationAreaFromCache();
 
     /// <summary>
-    /// Creates an index list from the triangle points
+    /// Rebuilds the query grid when the triangulation changed since the last query
     /// </summary>
-    /// <param name="triangles"> Needs a copy of the positional data of the spline </param>
-    /// <param name="vertices"> Empty array that will hold the reflex points afterwards </param>
-    /// <param name="indices"> Empty array that will hold the convex points afterwards </param>
-    void TrianglesToIndices(const TArray<MeshTriangle>& triangles, TArray<FVector>& vertices,
-                            TArray<int>& indices) const;
+    void UpdateAreaQuery() const;
+
+    /// <summary>
+    /// Snapshots the spline points and triangulates them on a worker thread
+    /// </summary>
+    void StartAsyncGeneration();
+    /// <summary>
+    /// Called on the game thread when a worker finished, applies the result if it is still the latest request
+    /// </summary>
+    /// <param name="serial"> Serial of the request the worker handled </param>
+    /// <param name="buildData"> Result of the worker, invalid when it got cancelled </param>
+    void FinishAsyncGeneration(int32 serial, TSharedPtr<FSplineAreaBuildData, ESPMode::ThreadSafe> buildData);
 
     //FUNCTIONS
 public:
+    /// <summary>
+    /// Copies everything a build needs from the area, has to run on the game thread
+    /// </summary>
+    void SnapshotBuildData(FSplineAreaBuildData& outBuildData) const;
+    /// <summary>
+    /// Triangulates the snapshot and builds its outline. Does not touch any UObject so it is safe to call from worker threads
+    /// </summary>
+    static void BuildAreaData(FSplineAreaBuildData& buildData);
+    /// <summary>
+    /// Takes over a finished build and pushes it to the mesh and outline, requests that are still running get dropped
+    /// </summary>
+    void ApplyBuildData(FSplineAreaBuildData&& buildData);
+
     // Called every frame
     virtual void Tick(float DeltaTime) override;
     virtual void OnConstruction(const FTransform& Transform);
 
     /// <summary>
-    /// Disables/Enables the collision en visibility of the teleportation area based on the boolean
+    /// Disables/Enables the collision en visibility of the teleportation area based on the boolean. Always restores the
+    /// components to the state, also when it did not change, a lazy area without resources only remembers the state
+    /// </summary>
+    UFUNCTION(BlueprintCallable)
+    void SetAreaActive(bool newState);
+
+    UFUNCTION(BlueprintPure)
+    bool IsAreaActive() const;
+
+    /// <summary>
+    /// Sets the actor a lazy area measures its distance to, for example the teleport controller. The pawn of the first
+    /// local player is used while no source is set
     /// </summary>
     UFUNCTION(BlueprintCallable)
-    void SetAreaActive(bool newState) const;
+    void SetRelevanceSource(AActor* source);
+
+    /// <summary>
+    /// False while a lazy area has released its mesh, collision and outline
+    /// </summary>
+    UFUNCTION(BlueprintPure)
+    bool IsAreaResident() const;
     
     /// <summary>
     /// Calls all the other functions to generate the area
     /// </summary>
     UFUNCTION(BLueprintCallable)
     void CreateTeleportationArea();
+
+    /// <summary>
+    /// Updates the area after a spline edit, only re-triangulates around the edited point when possible and falls back to
+    /// CreateTeleportationArea otherwise
+    /// </summary>
+    UFUNCTION(BlueprintCallable)
+    void UpdateTeleportationArea();
+
+    /// <summary>
+    /// Generates the area like CreateTeleportationArea but triangulates on a worker thread. Requests made while one is running
+    /// are coalesced into a single new run with the latest spline, OnAreaGenerated fires once the result is applied
+    /// </summary>
+    UFUNCTION(BlueprintCallable)
+    void CreateTeleportationAreaAsync();
+
+    /// <summary>
+    /// Fires after CreateTeleportationAreaAsync or USplineAreaSubsystem::RegenerateAllAreas applied its result to the mesh and outline
+    /// </summary>
+    UPROPERTY(BlueprintAssignable)
+    FOnSplineAreaGenerated OnAreaGenerated;
     
     /// <summary>
-    /// Clears the current spline and adds 4 linear points in the shape of a square based on the StandardSize variable
+    /// Shows the mesh section and outline of the LOD, 0 is the full area. Does nothing while the LODs are not built
+    /// </summary>
+    UFUNCTION(BlueprintCallable)
+    void SetAreaLOD(int32 lodIndex);
+
+    UFUNCTION(BlueprintPure)
+    int32 GetAreaLOD() const;
+
+    /// <summary>
+    /// Clears the current spline and adds 4 points in the shape of a square based on the StandardSize variable, the points are
+    /// linear unless the area is curved
     /// </summary>
     UFUNCTION(BlueprintCallable)
     void ClearSpline() const;
     
     /// <summary>
-    /// Returns a TArray with all the positional data of the spline
+    /// Checks if the location lies on the area without tracing against its collision
+    /// </summary>
+    /// <param name="location"> World location to check </param>
+    /// <param name="heightTolerance"> How far the location can be above or below the area surface </param>
+    UFUNCTION(BlueprintPure)
+    bool IsLocationInArea(const FVector& location, float heightTolerance = 50.f) const;
+
+    /// <summary>
+    /// Checks a batch of locations, outResults holds one entry per location in the same order
+    /// </summary>
+    /// <param name="locations"> World locations to check </param>
+    /// <param name="outResults"> Array that will hold if each location lies on the area afterwards </param>
+    /// <param name="heightTolerance"> How far the locations can be above or below the area surface </param>
+    UFUNCTION(BlueprintCallable)
+    void AreLocationsInArea(const TArray<FVector>& locations, TArray<bool>& outResults, float heightTolerance = 50.f) const;
+
+    /// <summary>
+    /// Finds the closest location on the area surface, that is the location itself when it lies above or below the area.
+    /// Returns false when the area has no triangles
+    /// </summary>
+    /// <param name="location"> World location to start from </param>
+    /// <param name="outNearestLocation"> Closest world location on the area </param>
+    UFUNCTION(BlueprintCallable)
+    bool FindNearestPointInArea(const FVector& location, FVector& outNearestLocation) const;
+
+    /// <summary>
+    /// Returns a TArray with all the positional data of the spline, in curved mode that is the flattened curve
     /// </summary>
     UFUNCTION(BlueprintPure)
     TArray<FVector> GetSplinePoints() const;
+
+    /// <summary>
+    /// Generated vertices, relative to the area mesh. The outline comes first and the points of every hole follow
+    /// </summary>
+    const TArray<FVector>& GetAreaVertices() const;
+    /// <summary>
+    /// Index of the first vertex of every hole in GetAreaVertices, empty when the area has no holes
+    /// </summary>
+    const TArray<int32>& GetAreaHoleStarts() const;
+    /// <summary>
+    /// Generated triangles as indices into GetAreaVertices
+    /// </summary>
+    const TArray<int32>& GetAreaIndices() const;
+    /// <summary>
+    /// Planar UVs of the generated vertices
+    /// </summary>
+    const TArray<FVector2D>& GetAreaUVs() const;
+    /// <summary>
+    /// Generated outline instances, relative to the outline component. Empty when the outline is disabled
+    /// </summary>
+    const TArray<FTransform>& GetOutlineTransforms() const;
+    FTransform GetAreaMeshTransform() const;
+    FTransform GetAreaOutlineTransform() const;
+    UMaterialInterface* GetAreaMeshMaterial() const;
+    UMaterialInterface* GetAreaOutlineMaterial() const;
+    UStaticMesh* GetAreaOutlineMesh() const;
+    /// <summary>
+    /// Width of the outline instances, 0 when the outline is disabled
+    /// </summary>
+    float GetAreaOutlineWidth() const;
+    float GetAreaUVTileSize() const;
+    bool ShouldMergeOverlappingAreas() const;
+
+    /// <summary>
+    /// Creates a transform for every edge of the closed outline and of every closed hole that stretches the outline mesh over it.
+    /// Does not touch any UObject so it is safe to call from worker threads
+    /// </summary>
+    /// <param name="splinePoints"> Positional data of the outline followed by the holes </param>
+    /// <param name="holeStarts"> Index of the first point of every hole </param>
+    /// <param name="outlineWidth"> Width of the outline </param>
+    /// <param name="outTransforms"> Array the transforms get appended to </param>
+    static void BuildOutlineTransforms(const TArray<FVector>& splinePoints, const TArray<int32>& holeStarts, float outlineWidth,
+                                       TArray<FTransform>& outTransforms);
+
+    /// <summary>
+    /// Sets the instances of the component to the given transforms. Existing instance slots are overwritten in one batch and only
+    /// the difference in count gets added or removed at the end
+    /// </summary>
+    /// <param name="instancedMesh"> Component to update </param>
+    /// <param name="transforms"> New instance transforms, relative to the component </param>
+    static void ApplyInstanceTransforms(UInstancedStaticMeshComponent* instancedMesh, const TArray<FTransform>& transforms);
 };
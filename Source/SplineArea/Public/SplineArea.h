@@ -4,6 +4,57 @@
 
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogSplineArea, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("SplineArea"), STATGROUP_SplineArea, STATCAT_Advanced);
+
+//Stages of the area generation, each one is a cycle counter, an Insights scope and a CSV timing through SPLINEAREA_SCOPE
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Triangulate"), STAT_SplineArea_Triangulate, STATGROUP_SplineArea, SPLINEAREA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("PolygonComponents"), STAT_SplineArea_PolygonComponents, STATGROUP_SplineArea, SPLINEAREA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("TrianglesFromPoints"), STAT_SplineArea_TrianglesFromPoints, STATGROUP_SplineArea, SPLINEAREA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("RetriangulateChangedPoints"), STAT_SplineArea_RetriangulateChangedPoints, STATGROUP_SplineArea,
+                          SPLINEAREA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CreateAreaMesh"), STAT_SplineArea_CreateAreaMesh, STATGROUP_SplineArea, SPLINEAREA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("UpdateAreaCollision"), STAT_SplineArea_UpdateAreaCollision, STATGROUP_SplineArea, SPLINEAREA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CreateAreaOutline"), STAT_SplineArea_CreateAreaOutline, STATGROUP_SplineArea, SPLINEAREA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CreateAreaLODs"), STAT_SplineArea_CreateAreaLODs, STATGROUP_SplineArea, SPLINEAREA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("UpdateAreaResources"), STAT_SplineArea_UpdateAreaResources, STATGROUP_SplineArea, SPLINEAREA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("UpdateAreaQuery"), STAT_SplineArea_UpdateAreaQuery, STATGROUP_SplineArea, SPLINEAREA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("FlushBatches"), STAT_SplineArea_FlushBatches, STATGROUP_SplineArea, SPLINEAREA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("RegenerateAllAreas"), STAT_SplineArea_RegenerateAllAreas, STATGROUP_SplineArea, SPLINEAREA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("MergeAreas"), STAT_SplineArea_MergeAreas, STATGROUP_SplineArea, SPLINEAREA_API);
+
+//Per frame totals of everything that got triangulated
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Vertices"), STAT_SplineArea_Vertices, STATGROUP_SplineArea, SPLINEAREA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Reflex Vertices"), STAT_SplineArea_ReflexVertices, STATGROUP_SplineArea, SPLINEAREA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Ear Iterations"), STAT_SplineArea_EarIterations, STATGROUP_SplineArea, SPLINEAREA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Triangles"), STAT_SplineArea_Triangles, STATGROUP_SplineArea, SPLINEAREA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Allocations"), STAT_SplineArea_Allocations, STATGROUP_SplineArea, SPLINEAREA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Scratch Bytes"), STAT_SplineArea_ScratchBytes, STATGROUP_SplineArea, SPLINEAREA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Incremental Fallbacks"), STAT_SplineArea_IncrementalFallbacks, STATGROUP_SplineArea,
+                                  SPLINEAREA_API);
+
+//Area generations over the last second, a per frame count would swing with the frame rate
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Rebuilds/s"), STAT_SplineArea_RebuildsPerSecond, STATGROUP_SplineArea, SPLINEAREA_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(SPLINEAREA_API, SplineArea);
+
+/// <summary>
+/// Times the rest of the scope as the given generation stage, stat STAT_SplineArea_StageName must be declared above
+/// </summary>
+#define SPLINEAREA_SCOPE(StageName) \
+    SCOPE_CYCLE_COUNTER(STAT_SplineArea_##StageName); \
+    TRACE_CPUPROFILER_EVENT_SCOPE(SplineArea_##StageName); \
+    CSV_SCOPED_TIMING_STAT(SplineArea, StageName)
+
+/// <summary>
+/// Counts one generation of an area towards the Rebuilds/s stat, game thread only
+/// </summary>
+SPLINEAREA_API void RecordAreaRebuild();
 
 class FSplineAreaModule : public IModuleInterface
 {
@@ -12,4 +63,12 @@ public:
     /** IModuleInterface implementation */
     virtual void StartupModule() override;
     virtual void ShutdownModule() override;
+
+private:
+    /// <summary>
+    /// Publishes the rebuilds of the last second as the Rebuilds/s stat and CSV value, runs at the end of every frame
+    /// </summary>
+    void PublishRebuildRate();
+
+    FDelegateHandle EndFrameHandle;
 };
@@ -0,0 +1,374 @@
+// Copyright 2021 Robin Smekens
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+/// <summary>
+/// Polygon triangulation used by ASplineArea. This is plain C++ without any engine types so it can be built and measured
+/// outside of the editor, ASplineArea only converts its spline points into these types and back
+/// </summary>
+namespace SplineAreaGeometry
+{
+    struct Vector3
+    {
+        float X = 0.f;
+        float Y = 0.f;
+        float Z = 0.f;
+    };
+
+    struct Triangle
+    {
+        Vector3 Point1 = Vector3();
+        Vector3 Point2 = Vector3();
+        Vector3 Point3 = Vector3();
+    };
+
+    /// <summary>
+    /// Index tables of the different types of vertices in a polygon
+    /// </summary>
+    struct PolygonComponents
+    {
+        //Points left after removing duplicate and collinear points, in counter clockwise order. The triangles only use these
+        std::vector<int> RingIndices;
+        std::vector<int> ReflexIndices;
+        std::vector<int> ConvexIndices;
+        std::vector<int> EarIndices;
+        //Set when edges of the polygon cross or touch, the triangles still cover the outline but overlap where it crosses
+        bool bSelfIntersecting = false;
+    };
+
+    /// <summary>
+    /// Counters of one triangulation, filled when the caller asks for them
+    /// </summary>
+    struct TriangulationStats
+    {
+        int VertexCount = 0;
+        //Duplicate and collinear points that were left out of the triangulation
+        int RemovedPoints = 0;
+        int ReflexCount = 0;
+        //Steps around the ring while looking for ears, one per visited vertex
+        int EarIterations = 0;
+        int TrianglesEmitted = 0;
+        //Heap allocations the triangulation made, zero once the scratch buffers fit the polygon, and the size of those buffers
+        int Allocations = 0;
+        int ScratchBytes = 0;
+        bool bSelfIntersecting = false;
+    };
+
+    /// <summary>
+    /// Uniform grid over the triangles and boundary edges of a triangulated polygon, answers point queries without touching
+    /// more than a few cells. Points outside of the bounding box of the polygon get rejected before the grid is used
+    /// </summary>
+    class AreaQueryGrid
+    {
+    public:
+        /// <summary>
+        /// Builds the grid, the points are the polygon in order and the indices its triangulation. The points can hold holes
+        /// after the outline like in TriangulatePolygonWithHoles, every hole then gets a boundary of its own
+        /// </summary>
+        void Build(const std::vector<Vector3>& points, const std::vector<int>& indices,
+                   const std::vector<int>& holeStarts = std::vector<int>());
+        void Reset();
+        bool IsEmpty() const;
+
+        /// <summary>
+        /// Returns the triangle that contains the point on the XY plane or -1, outHeight is the height of the triangle at that point
+        /// </summary>
+        int FindTriangle(float x, float y, float& outHeight) const;
+
+        /// <summary>
+        /// Finds the closest point of the area, that is the point itself when it is inside and else the closest point on the
+        /// polygon outline. The Z of the result lies on the area. Returns false when the grid is empty
+        /// </summary>
+        bool FindNearestPoint(float x, float y, Vector3& outPoint) const;
+
+    private:
+        int CellX(float x) const;
+        int CellY(float y) const;
+
+        std::vector<Vector3> Points;
+        std::vector<int> Indices;
+        //Second point of the boundary edge that starts at every point
+        std::vector<int> EdgeEnds;
+
+        float MinX = 0.f;
+        float MinY = 0.f;
+        float MaxX = 0.f;
+        float MaxY = 0.f;
+        float CellSize = 1.f;
+        int CellCountX = 0;
+        int CellCountY = 0;
+
+        //Per cell ranges into the item arrays, cell i owns the items from Starts[i] up to Starts[i + 1]
+        std::vector<int> TriangleCellStarts;
+        std::vector<int> TriangleCellItems;
+        std::vector<int> EdgeCellStarts;
+        std::vector<int> EdgeCellItems;
+    };
+
+    struct TriangulatorScratch;
+
+    /// <summary>
+    /// Ear clipping triangulator that keeps its scratch buffers between calls. The buffers only grow, so after the first
+    /// polygon of a given size triangulating does not allocate anymore. One triangulator must not be used by two threads at once
+    /// </summary>
+    class Triangulator
+    {
+    public:
+        Triangulator();
+        ~Triangulator();
+        Triangulator(const Triangulator&) = delete;
+        Triangulator& operator=(const Triangulator&) = delete;
+
+        /// <summary>
+        /// Classifies the points like GetPolygonComponents, the result is kept in the triangulator until the next call
+        /// </summary>
+        const PolygonComponents& ClassifyPoints(const std::vector<Vector3>& points);
+
+        /// <summary>
+        /// Clips the ears of the points last passed to ClassifyPoints like TrianglesFromPoints
+        /// </summary>
+        void ClipEars(const std::vector<Vector3>& points, std::vector<int>& outIndices, TriangulationStats* outStats = nullptr);
+
+        /// <summary>
+        /// Runs ClassifyPoints and ClipEars on the polygon
+        /// </summary>
+        void Triangulate(const std::vector<Vector3>& points, std::vector<int>& outIndices, TriangulationStats* outStats = nullptr);
+
+        /// <summary>
+        /// Triangulates an outline with holes like TriangulatePolygonWithHoles
+        /// </summary>
+        void TriangulateWithHoles(const std::vector<Vector3>& points, const std::vector<int>& holeStarts,
+                                  std::vector<int>& outIndices, TriangulationStats* outStats = nullptr);
+
+    private:
+        std::unique_ptr<TriangulatorScratch> Scratch;
+    };
+
+    /// <summary>
+    /// If the index is larger then length it will loop around
+    /// </summary>
+    /// <param name="index"> index to transform </param>
+    /// <param name="length"> maximum value -> length of the array </param>
+    inline int CircularIndex(const int index, const int length)
+    {
+        const int temp = index % length;
+        if (temp < 0)
+            return temp + length;
+
+        return temp;
+    }
+
+    /// <summary>
+    /// Exact sign of the orientation of c relative to the line from a to b on the XY plane: 1 when c lies to the left (counter
+    /// clockwise), -1 when it lies to the right and 0 when the three points are collinear. A double evaluation with an error
+    /// bound answers almost every call, only results inside of that bound get summed exactly
+    /// </summary>
+    int OrientationSign(const Vector3& a, const Vector3& b, const Vector3& c);
+
+    /// <summary>
+    /// Checks if the corner at curPoint is convex, the polygon is expected to be counter clockwise on the XY plane
+    /// </summary>
+    /// <param name="prevPoint"> point before the corner </param>
+    /// <param name="curPoint"> corner point </param>
+    /// <param name="nextPoint"> point after the corner </param>
+    bool PointIsConvex(const Vector3& prevPoint, const Vector3& curPoint, const Vector3& nextPoint);
+
+    /// <summary>
+    /// Checks if p lies inside or on the edge of the triangle t1, t2, t3 on the XY plane, the triangle can wind either way
+    /// </summary>
+    bool IsPointInTriangle(const Vector3& t1, const Vector3& t2, const Vector3& t3, const Vector3& p);
+
+    /// <summary>
+    /// Checks which corners of a closed ring are convex for a whole batch at once (SSE/AVX when available), corners too close to
+    /// call in float precision get decided by OrientationSign.
+    /// The packed coordinates hold the ring with one point of padding on both sides: xs[0] is the last point of the ring and
+    /// xs[count + 1] the first one. outConvex[i] is set to 1 when the corner at xs[i + 1] is convex
+    /// </summary>
+    void ClassifyConvexBatch(const float* xs, const float* ys, int count, unsigned char* outConvex);
+
+    /// <summary>
+    /// Checks a batch of packed points against the counter clockwise triangle a, b, c at once (SSE/AVX when available).
+    /// Returns true when any point lies inside or on the triangle, points too close to an edge to call in float precision get
+    /// decided by OrientationSign. Points at the exact position of a corner and NaN points are
+    /// ignored, so the neighbours of an ear, the second ends of hole bridges and points that got removed never block it
+    /// </summary>
+    bool AnyPointInTriangleBatch(const float* xs, const float* ys, int count, const Vector3& a, const Vector3& b,
+                                 const Vector3& c);
+
+    /// <summary>
+    /// Signed area of the polygon on the XY plane, positive for counter clockwise polygons
+    /// </summary>
+    float PolygonArea(const std::vector<Vector3>& points);
+
+    /// <summary>
+    /// Signed area of the triangle on the XY plane, positive for counter clockwise triangles
+    /// </summary>
+    float TriangleArea(const Vector3& t1, const Vector3& t2, const Vector3& t3);
+
+    /// <summary>
+    /// Figures out which points are convex, reflex, ear. Based on this we create an index table for each type.
+    /// Duplicate and collinear points get left out first, clockwise polygons get walked backwards and crossing edges get flagged
+    /// </summary>
+    /// <param name="points"> Positional data of the polygon </param>
+    /// <param name="outComponents"> Tables that will hold the ring, reflex, convex and ear indices afterwards </param>
+    void GetPolygonComponents(const std::vector<Vector3>& points, PolygonComponents& outComponents);
+
+    /// <summary>
+    /// From the different types of vertices can figure out how the triangles need to laid out for the mesh.
+    /// Clips ears iteratively from a linked ring of the points, only the neighbours of a clipped ear get reclassified
+    /// </summary>
+    /// <param name="points"> Positional data of the polygon </param>
+    /// <param name="components"> Vertex types produced by GetPolygonComponents for the same points </param>
+    /// <param name="outIndices"> Array the clipped triangles get appended to, as indices into points. These are
+    /// RingIndices.size() - 2 triangles which wind opposite to the ring </param>
+    /// <param name="outStats"> Optional counters of the clipping </param>
+    void TrianglesFromPoints(const std::vector<Vector3>& points, const PolygonComponents& components,
+                             std::vector<int>& outIndices, TriangulationStats* outStats = nullptr);
+
+    /// <summary>
+    /// Creates an index list from loose triangle points by welding equal positions, only needed for triangles that do not come
+    /// from TrianglesFromPoints (that one already indexes the polygon points)
+    /// </summary>
+    /// <param name="triangles"> Triangles to weld </param>
+    /// <param name="vertices"> Array that will hold the unique vertices afterwards, vertices already in it are reused </param>
+    /// <param name="indices"> Array the indices get appended to </param>
+    void TrianglesToIndices(const std::vector<Triangle>& triangles, std::vector<Vector3>& vertices,
+                            std::vector<int>& indices);
+
+    /// <summary>
+    /// Runs GetPolygonComponents and TrianglesFromPoints on the polygon. The free triangulation functions share one set of
+    /// scratch buffers per thread, so repeated calls do not allocate either
+    /// </summary>
+    void TriangulatePolygon(const std::vector<Vector3>& points, std::vector<int>& outIndices,
+                            TriangulationStats* outStats = nullptr);
+
+    /// <summary>
+    /// Triangulates an outline with holes in one pass. Every hole gets connected to the outline by a bridge (Eberly) so the
+    /// outline and the holes become one ring that the ear clipping walks around, the triangles index straight into points.
+    /// Holes that lie outside of the outline or cross it get left out, crossings between any of the loops get flagged in the stats
+    /// </summary>
+    /// <param name="points"> The outline followed by the points of every hole, every loop can wind either way </param>
+    /// <param name="holeStarts"> Index of the first point of every hole in points, in increasing order. Empty without holes </param>
+    /// <param name="outIndices"> Array the triangles get appended to, they wind opposite to the outline like TrianglesFromPoints </param>
+    /// <param name="outStats"> Optional counters of the triangulation </param>
+    void TriangulatePolygonWithHoles(const std::vector<Vector3>& points, const std::vector<int>& holeStarts,
+                                     std::vector<int>& outIndices, TriangulationStats* outStats = nullptr);
+
+    /// <summary>
+    /// Triangles around every point of a triangulation. Kept next to the indices between edits, so the local updates below find
+    /// the triangles of a point without going over the whole triangulation
+    /// </summary>
+    class PointTriangleAdjacency
+    {
+    public:
+        /// <summary>
+        /// Builds the triangle lists of pointCount points from the indices
+        /// </summary>
+        void Build(int pointCount, const std::vector<int>& indices);
+        void Reset();
+        int GetPointCount() const;
+
+        /// <summary>
+        /// Triangles that have the point as one of their corners, in no particular order
+        /// </summary>
+        const std::vector<int>& GetTriangles(int pointIndex) const;
+
+        /// <summary>
+        /// Adds or removes the triangle in the lists of its three corners as the indices list them
+        /// </summary>
+        void AddTriangle(const std::vector<int>& indices, int triangle);
+        void RemoveTriangle(const std::vector<int>& indices, int triangle);
+
+        /// <summary>
+        /// Adds an empty list for a point inserted at pointIndex, or drops the list of a removed point. The lists only hold
+        /// triangles, so the other points keep theirs
+        /// </summary>
+        void InsertPoint(int pointIndex);
+        void RemovePoint(int pointIndex);
+
+    private:
+        std::vector<std::vector<int>> PointTriangles;
+    };
+
+    /// <summary>
+    /// Re-triangulates only the fan of triangles around a point that moved, all other triangles are kept as they are.
+    /// Returns false and leaves the indices and adjacency untouched when the local update would not give the triangulation of
+    /// the cleaned polygon, like when the move made a collinear neighbour count again or flipped the winding
+    /// </summary>
+    /// <param name="points"> Positional data of the polygon with the point already moved </param>
+    /// <param name="pointIndex"> Index of the point that moved </param>
+    /// <param name="indices"> Triangulation of the polygon before the point moved, updated in place </param>
+    /// <param name="adjacency"> Triangles around every point of the indices, updated in place </param>
+    bool RetriangulateMovedPoint(const std::vector<Vector3>& points, int pointIndex, std::vector<int>& indices,
+                                 PointTriangleAdjacency& adjacency);
+
+    /// <summary>
+    /// Splits the triangle on the edge a new point got inserted in, all other triangles are kept and only renumbered.
+    /// Returns false and leaves the indices and adjacency untouched when the local update would not give a valid triangulation
+    /// </summary>
+    /// <param name="points"> Positional data of the polygon with the point already inserted </param>
+    /// <param name="pointIndex"> Index the new point got inserted at </param>
+    /// <param name="indices"> Triangulation of the polygon before the insert, updated in place </param>
+    /// <param name="adjacency"> Triangles around every point of the indices, updated in place </param>
+    bool RetriangulateInsertedPoint(const std::vector<Vector3>& points, int pointIndex, std::vector<int>& indices,
+                                    PointTriangleAdjacency& adjacency);
+
+    /// <summary>
+    /// Re-triangulates only the fan of triangles around a point that got removed, all other triangles are kept and only renumbered.
+    /// Returns false and leaves the indices and adjacency untouched when the local update would not give a valid triangulation
+    /// </summary>
+    /// <param name="points"> Positional data of the polygon with the point already removed </param>
+    /// <param name="pointIndex"> Index the point had before it got removed </param>
+    /// <param name="indices"> Triangulation of the polygon before the removal, updated in place </param>
+    /// <param name="adjacency"> Triangles around every point of the indices, updated in place </param>
+    bool RetriangulateRemovedPoint(const std::vector<Vector3>& points, int pointIndex, std::vector<int>& indices,
+                                   PointTriangleAdjacency& adjacency);
+
+    /// <summary>
+    /// Simplifies the polygon with Douglas-Peucker, every removed point lies within maxError of the simplified outline.
+    /// At least 3 points are kept
+    /// </summary>
+    /// <param name="points"> Positional data of the polygon </param>
+    /// <param name="maxError"> Largest allowed distance between a removed point and the simplified outline </param>
+    /// <param name="outKeptIndices"> Array that will hold the indices of the kept points in order afterwards </param>
+    void SimplifyPolygon(const std::vector<Vector3>& points, float maxError, std::vector<int>& outKeptIndices);
+
+    /// <summary>
+    /// Splits the triangulated polygon into convex pieces with Hertel-Mehlhorn, neighbouring triangles get merged as long as the
+    /// result stays convex. Gives at most 4 times the pieces of the optimal partition
+    /// </summary>
+    /// <param name="points"> Positional data of the polygon </param>
+    /// <param name="indices"> Triangulation of the polygon as produced by TriangulatePolygon </param>
+    /// <param name="maxPieceVertices"> Pieces do not grow past this vertex count, convex hulls in physics engines are limited </param>
+    /// <param name="outPieces"> Array that will hold the counter clockwise indices of every piece afterwards </param>
+    void ConvexPartition(const std::vector<Vector3>& points, const std::vector<int>& indices, int maxPieceVertices,
+                         std::vector<std::vector<int>>& outPieces);
+
+    /// <summary>
+    /// One connected piece of a polygon union
+    /// </summary>
+    struct PolygonUnionPiece
+    {
+        //Counter clockwise outline of the piece
+        std::vector<Vector3> Outer;
+        //Clockwise outlines of the gaps the piece encloses, holes of the polygons that no other polygon covers end up here too
+        std::vector<std::vector<Vector3>> Holes;
+        //Indices of the input polygons that were merged together with the polygons this piece came from
+        std::vector<int> SourcePolygons;
+    };
+
+    /// <summary>
+    /// Merges the polygons into their union on the XY plane. A bounding box broad phase splits the polygons into groups first,
+    /// within a group a sweep over the edges by x finds the crossings and only the edge pieces that no other polygon covers are
+    /// kept. Polygons whose bounding boxes also overlap in Z get merged, so areas stacked on different floors stay apart.
+    /// Polygons that cross themselves have no clear inside and get passed through on their own
+    /// </summary>
+    /// <param name="polygons"> Positional data of the polygons, either winding </param>
+    /// <param name="polygonHoleStarts"> Holes of every polygon like in TriangulatePolygonWithHoles, empty when there are none </param>
+    /// <param name="outPieces"> Array that will hold the pieces of the union afterwards </param>
+    void UnionPolygons(const std::vector<std::vector<Vector3>>& polygons, const std::vector<std::vector<int>>& polygonHoleStarts,
+                       std::vector<PolygonUnionPiece>& outPieces);
+}
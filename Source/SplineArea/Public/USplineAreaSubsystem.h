@@ -0,0 +1,156 @@
+// Copyright 2021 Robin Smekens
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "USplineAreaSubsystem.generated.h"
+
+class ASplineArea;
+class UMaterialInterface;
+class UStaticMesh;
+class UProceduralMeshComponent;
+class UInstancedStaticMeshComponent;
+
+/// <summary>
+/// Range of one area inside the combined buffers of a batch
+/// </summary>
+struct FSplineAreaBatchEntry
+{
+    TWeakObjectPtr<const ASplineArea> Area;
+    int32 VertexStart = 0;
+    int32 VertexCount = 0;
+    int32 IndexStart = 0;
+    int32 IndexCount = 0;
+    int32 InstanceStart = 0;
+    int32 InstanceCount = 0;
+    bool bVisible = true;
+    bool bDirty = true;
+};
+
+/// <summary>
+/// All registered areas that share the same materials and outline mesh, drawn with one mesh section and one outline component
+/// </summary>
+USTRUCT()
+struct FSplineAreaBatch
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    UMaterialInterface* MeshMaterial = nullptr;
+    UPROPERTY()
+    UMaterialInterface* OutlineMaterial = nullptr;
+    UPROPERTY()
+    UStaticMesh* OutlineMesh = nullptr;
+
+    UPROPERTY()
+    UProceduralMeshComponent* Mesh = nullptr;
+    UPROPERTY()
+    UInstancedStaticMeshComponent* Outline = nullptr;
+
+    TArray<FSplineAreaBatchEntry> Entries;
+
+    //Combined world space data of all entries, every entry owns one range of each
+    TArray<FVector> Vertices;
+    TArray<FVector2D> UVs;
+    TArray<int32> Indices;
+    TArray<FTransform> OutlineTransforms;
+
+    bool bHasDirtyEntries = false;
+    bool bLayoutDirty = true;
+
+    //Set for areas with bMergeOverlappingAreas, the batch then draws the union of its areas and gets rebuilt as a whole on
+    //every change. Merged areas also need the same outline width and UV tile size, the union has no per area data
+    bool bMergeAreas = false;
+    float OutlineWidth = 0.f;
+    float UVTileSize = 1.f;
+};
+
+/// <summary>
+/// Opt-in batching of spline areas. Areas with bUseSharedBatch register here on BeginPlay and hide their own mesh and outline,
+/// every group of areas with the same materials is drawn by one shared mesh section and one outline component instead.
+/// Collision stays on the areas themselves. Changes are collected and flushed once per frame, an area that keeps its vertex,
+/// index and instance count only patches its own range. Areas with bMergeOverlappingAreas get their own batches which draw the
+/// union of the areas instead, so overlaps are drawn once and the outline skips the seams between areas
+/// </summary>
+UCLASS()
+class SPLINEAREA_API USplineAreaSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+    GENERATED_BODY()
+
+public:
+    virtual void Deinitialize() override;
+
+    virtual void Tick(float DeltaTime) override;
+    virtual bool IsTickable() const override;
+    virtual ETickableTickType GetTickableTickType() const override;
+    virtual bool IsTickableWhenPaused() const override;
+    virtual UWorld* GetTickableGameObjectWorld() const override;
+    virtual TStatId GetStatId() const override;
+
+    /// <summary>
+    /// Adds the area to the batch of its materials, the area is drawn by the batch from the next flush on
+    /// </summary>
+    void RegisterArea(const ASplineArea* area);
+    /// <summary>
+    /// Removes the area from its batch, the other areas of the batch get packed again on the next flush
+    /// </summary>
+    void UnregisterArea(const ASplineArea* area);
+    bool IsAreaRegistered(const ASplineArea* area) const;
+
+    /// <summary>
+    /// Marks the generated data of the area as changed, it gets copied into the batch on the next flush
+    /// </summary>
+    void MarkAreaDirty(const ASplineArea* area);
+    /// <summary>
+    /// Shows or hides the range of the area in its batch, hidden areas keep their range with collapsed vertices and zero scale
+    /// outline instances so toggling never repacks the batch
+    /// </summary>
+    void SetAreaVisible(const ASplineArea* area, bool bVisible);
+
+    /// <summary>
+    /// Regenerates every spline area in the world. The spline points of all areas get snapshot first, then the areas get
+    /// triangulated in parallel on the worker threads and the results are applied to the components in one game thread pass
+    /// </summary>
+    UFUNCTION(BlueprintCallable)
+    void RegenerateAllAreas();
+
+    /// <summary>
+    /// Pushes all pending changes to the batch components, runs every frame but can be called to apply changes right away
+    /// </summary>
+    void FlushBatches();
+
+private:
+    FSplineAreaBatchEntry* FindEntry(const ASplineArea* area, FSplineAreaBatch*& outBatch);
+    /// <summary>
+    /// Returns the index of the batch matching the materials of the area, creates the batch and its components when needed
+    /// </summary>
+    int32 FindOrAddBatch(const ASplineArea* area);
+
+    /// <summary>
+    /// Rebuilds the combined buffers of the batch from all its areas and recreates the mesh section
+    /// </summary>
+    void RebuildBatch(FSplineAreaBatch& batch) const;
+    /// <summary>
+    /// Rebuilds a merging batch from the union of its visible areas
+    /// </summary>
+    void RebuildMergedBatch(FSplineAreaBatch& batch) const;
+    /// <summary>
+    /// Copies the current data of one area into its existing range, returns false when the area no longer fits the range
+    /// </summary>
+    bool PatchEntry(FSplineAreaBatch& batch, FSplineAreaBatchEntry& entry, bool& bOutIndicesChanged) const;
+    /// <summary>
+    /// Writes the vertices, UVs and outline transforms of an area at the start of its range, collapsed when it is hidden
+    /// </summary>
+    void WriteEntryData(FSplineAreaBatch& batch, const FSplineAreaBatchEntry& entry) const;
+
+    UPROPERTY()
+    AActor* BatchActor = nullptr;
+
+    UPROPERTY()
+    TArray<FSplineAreaBatch> Batches;
+
+    //Batch index (X) and entry index (Y) of every registered area
+    TMap<const ASplineArea*, FIntPoint> AreaEntries;
+};
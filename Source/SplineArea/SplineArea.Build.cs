@@ -26,6 +26,7 @@ public class SplineArea : ModuleRules
 			new string[]
 			{
 				"Core",
+				"ProceduralMeshComponent",
 				// ... add other public dependencies that you statically link with here ...
 			}
 			);
@@ -37,8 +38,7 @@ public class SplineArea : ModuleRules
 				"CoreUObject",
 				"Engine",
 				"Slate",
-				"SlateCore",
-				"ProceduralMeshComponent"
+				"SlateCore"
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);